@@ -0,0 +1,191 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: arenaGen.c
+	Options of a game (parsed from the gameType string given to `waitForSnakeGame`)
+	and local generation of arenas (to play games without the server)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "clientAPI.h"
+#include "arenaGen.h"
+
+
+
+/* -----------------------------------------------------------------------
+ * Parse a gameType string (as given to `waitForSnakeGame`), like
+ * "TRAINING RANDOM_PLAYER difficulty=2 timeout=100 seed=123 start=0"
+ * The unknown keys are ignored, as the server does
+ *
+ * Returns 0 if the string is valid, -1 if a value is invalid
+ */
+int parseGameType(const char* gameType, t_gameOptions* opt) {
+	opt->command[0] = 0;
+	opt->difficulty = 2;
+	opt->timeout = -1;
+	opt->seed = -1;
+	opt->start = -1;
+	opt->sizeX = DEFAULT_SIZE_X;
+	opt->sizeY = DEFAULT_SIZE_Y;
+	if (!gameType)
+		return 0;
+
+	char word[151];
+	int n, ret = 0;
+	const char* p = gameType;
+	while (sscanf(p, "%150s%n", word, &n) == 1) {
+		p += n;
+		char* eq = strchr(word, '=');
+		if (!eq) {
+			/* part of the command */
+			if (strlen(opt->command) + strlen(word) + 2 <= sizeof(opt->command)) {
+				if (opt->command[0])
+					strcat(opt->command, " ");
+				strcat(opt->command, word);
+			}
+			continue;
+		}
+		*eq = 0;
+		char* end;
+		long v = strtol(eq + 1, &end, 10);
+		int valid = *end == 0 && end != eq + 1;
+		if (strcmp(word, "difficulty") == 0) {
+			valid = valid && v >= 0 && v <= 3;
+			opt->difficulty = v;
+		}
+		else if (strcmp(word, "timeout") == 0) {
+			valid = valid && v > 0;
+			opt->timeout = v;
+		}
+		else if (strcmp(word, "seed") == 0) {
+			valid = valid && v >= 0;
+			opt->seed = v;
+		}
+		else if (strcmp(word, "start") == 0) {
+			valid = valid && (v == 0 || v == 1);
+			opt->start = v;
+		}
+		else if (strcmp(word, "sizeX") == 0) {
+			valid = valid && v >= 5 && v <= 1000;
+			opt->sizeX = v;
+		}
+		else if (strcmp(word, "sizeY") == 0) {
+			valid = valid && v >= 1 && v <= 1000;
+			opt->sizeY = v;
+		}
+		else
+			continue;
+		if (!valid) {
+			dispDebug(__FUNCTION__, 1, "Invalid value for the key %s", word);
+			ret = -1;
+		}
+	}
+	return ret;
+}
+
+
+/* ---------------------------------------------------------------------------
+ * Write the options as a gameType string (max 150 characters), to be used with `waitForSnakeGame`
+ */
+void formatGameType(const t_gameOptions* opt, char* gameType) {
+	int n = snprintf(gameType, 151, "%s difficulty=%d", opt->command, opt->difficulty);
+	if (opt->timeout > 0 && n < 150)
+		n += snprintf(gameType + n, 151 - n, " timeout=%d", opt->timeout);
+	if (opt->seed >= 0 && n < 150)
+		n += snprintf(gameType + n, 151 - n, " seed=%ld", opt->seed);
+	if (opt->start >= 0 && n < 150)
+		snprintf(gameType + n, 151 - n, " start=%d", opt->start);
+}
+
+
+/* -----------------------------------------------------------------
+ * Pseudo-random generator (splitmix64), with its state given by the caller
+ */
+unsigned long long nextRandom(unsigned long long* state) {
+	unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+
+/* -------------------------------------------------------------------------
+ * Generate an arena from the options (seed, difficulty and size)
+ * The walls are symmetric (x <-> sizeX-1-x), so that the two starting cells are equivalent
+ *
+ * Returns the game (to be freed with `freeGame`)
+ */
+t_game* generateArena(const t_gameOptions* opt) {
+	int sizeX = opt->sizeX, sizeY = opt->sizeY;
+	unsigned long long state = opt->seed >= 0 ? (unsigned long long) opt->seed : 0;
+
+	/* about 5% of the cells have a wall for each level of difficulty */
+	int nbPairs = sizeX * sizeY * opt->difficulty / 40;
+	int* walls = malloc(8 * (nbPairs + 1) * sizeof(int));
+	if (!walls)
+		dispError(__FUNCTION__, "Cannot allocate the walls");
+
+	int nbWalls = 0;
+	for (int i = 0; i < nbPairs; i++) {
+		int x = nextRandom(&state) % sizeX, y = nextRandom(&state) % sizeY;
+		int vertical = nextRandom(&state) % 2;
+		int x2 = x + !vertical, y2 = y + vertical;
+		if (x2 >= sizeX || y2 >= sizeY)
+			continue;
+		int* w = walls + 4 * nbWalls;
+		w[0] = x; w[1] = y; w[2] = x2; w[3] = y2;
+		nbWalls++;
+		/* symmetric wall (skipped when it is the same) */
+		if (sizeX - 1 - x2 != x) {
+			w[4] = sizeX - 1 - x2; w[5] = y; w[6] = sizeX - 1 - x; w[7] = y2;
+			nbWalls++;
+		}
+	}
+
+	t_game* game = newGame(sizeX, sizeY, nbWalls, walls);
+	free(walls);
+	return game;
+}
+
+
+/* -------------------------------------------------------------------------
+ * Fill the array walls with the walls of a game (same format as `getSnakeArena`:
+ * x1, y1, x2, y2 for a wall between (x1,y1) and (x2,y2)); the array must have 8*nbCells entries
+ *
+ * Returns the number of walls
+ */
+int arenaWalls(const t_game* game, int* walls) {
+	int nb = 0;
+	for (int y = 0; y < game->sizeY; y++)
+		for (int x = 0; x < game->sizeX; x++) {
+			int c = CELL(game, x, y);
+			/* wall on the east or south side (but not on the border) */
+			if (x + 1 < game->sizeX && game->next[4 * c + EAST] < 0) {
+				int* w = walls + 4 * nb++;
+				w[0] = x; w[1] = y; w[2] = x + 1; w[3] = y;
+			}
+			if (y + 1 < game->sizeY && game->next[4 * c + SOUTH] < 0) {
+				int* w = walls + 4 * nb++;
+				w[0] = x; w[1] = y; w[2] = x; w[3] = y + 1;
+			}
+		}
+	return nb;
+}
@@ -0,0 +1,87 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: arenaGen.h
+	Options of a game (parsed from the gameType string given to `waitForSnakeGame`)
+	and local generation of arenas (to play games without the server)
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_ARENA_GEN__
+#define __SNAKE_ARENA_GEN__
+#include "snakeGame.h"
+
+
+#define DEFAULT_SIZE_X 40		/* size of the arenas generated locally (when not given in the options) */
+#define DEFAULT_SIZE_Y 20
+
+
+/* Options of a game */
+typedef struct {
+	char command[151];		/* command, like "TRAINING SUPER_PLAYER" */
+	int difficulty;			/* between 0 (no walls) and 3 (a lot of walls), 2 by default */
+	int timeout;			/* in seconds (-1 if not given) */
+	long seed;				/* seed of the random generator (-1 if not given) */
+	int start;				/* who starts (0 or 1, -1 if not given) */
+	int sizeX, sizeY;		/* size of the arena (only used locally, ignored by the server) */
+} t_gameOptions;
+
+
+
+/* -----------------------------------------------------------------------
+ * Parse a gameType string (as given to `waitForSnakeGame`), like
+ * "TRAINING RANDOM_PLAYER difficulty=2 timeout=100 seed=123 start=0"
+ * The unknown keys are ignored, as the server does
+ *
+ * Returns 0 if the string is valid, -1 if a value is invalid
+ */
+int parseGameType(const char* gameType, t_gameOptions* opt);
+
+
+/* ---------------------------------------------------------------------------
+ * Write the options as a gameType string (max 150 characters), to be used with `waitForSnakeGame`
+ */
+void formatGameType(const t_gameOptions* opt, char* gameType);
+
+
+/* -----------------------------------------------------------------
+ * Pseudo-random generator (splitmix64), with its state given by the caller
+ */
+unsigned long long nextRandom(unsigned long long* state);
+
+
+/* -------------------------------------------------------------------------
+ * Generate an arena from the options (seed, difficulty and size)
+ * The walls are symmetric (x <-> sizeX-1-x), so that the two starting cells are equivalent
+ *
+ * Returns the game (to be freed with `freeGame`)
+ */
+t_game* generateArena(const t_gameOptions* opt);
+
+
+/* -------------------------------------------------------------------------
+ * Fill the array walls with the walls of a game (same format as `getSnakeArena`:
+ * x1, y1, x2, y2 for a wall between (x1,y1) and (x2,y2)); the array must have 8*nbCells entries
+ *
+ * Returns the number of walls
+ */
+int arenaWalls(const t_game* game, int* walls);
+
+
+#endif
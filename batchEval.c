@@ -0,0 +1,361 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: batchEval.c
+	Batch evaluation of positions by the bot (snakeBot.h): the positions are read from
+	a file (or a pipe), searched in parallel with a fixed time budget each, and the best
+	move and its score are written in the order of the input
+
+	A position is given by a line "sizeX sizeY nbWalls x1 y1 x2 y2 ... moves":
+	the arena (walls as given by `getSnakeArena`) and the moves played since the start,
+	one digit (0 to 3) by move ("-" if there is none); the player that has to play is
+	given by the number of moves. The empty lines and the lines beginning by # are ignored.
+	For each position, a line "move score" is written ("- invalid" if the position is invalid,
+	"- blocked" if the player has no legal move)
+
+	The reader hands the positions out to the threads (each one has its own queue, and an
+	idle thread steals from the others); at most `window` positions are in memory at once,
+	and the results are written as soon as the ones before are known
+
+	Compile with: gcc -O2 batchEval.c snakeBot.c snakeGame.c chamber.c endgame.c tablebase.c clientAPI.c -pthread -lm
+
+	Usage: batchEval [-t threads] [-b budget] [-v params] [-T tablebase] [-w window] [-o output] [input]
+	  -t: number of threads (number of cores by default)
+	  -b: time budget of each position, in seconds (0.1 by default, 0 for a fixed depth)
+	  -v: parameter file of the bot (default parameters otherwise)
+	  -T: tablebase of an arena (built by tbBuild.c), the positions of this arena are read in it
+	  -w: maximal number of positions in memory (64 by thread by default)
+	  -o: output file (standard output by default)
+	  input: the positions (standard input by default)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "clientAPI.h"
+#include "snakeBot.h"
+
+
+#define WINDOW_BY_THREAD 64		/* default number of positions in memory, by thread */
+#define RESULT_SIZE 64			/* maximal size of a result line */
+
+
+/* A position to evaluate (slot of the window) */
+typedef struct {
+	char* line;					/* the position, as read */
+	char result[RESULT_SIZE];
+	int done;					/* 1 when the result is known */
+} t_slot;
+
+/* Queue of positions of a thread (indexes of the positions, circular, capacity window) */
+typedef struct {
+	pthread_mutex_t mutex;
+	long* pos;
+	long first, nb;
+} t_queue;
+
+
+/* shared by the threads */
+static t_params params;
+static t_tablebase* tablebase = NULL;
+static double budget = 0.1;
+static int nbThreads;
+static long window;
+static t_slot* slots;			/* the position i is in slots[i % window] */
+static t_queue* queues;
+static FILE* out;
+static long nbRead = 0;			/* number of positions read */
+static long nbWritten = 0;		/* number of results written */
+static int eof = 0;				/* 1 when all the positions are read */
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;	/* protects nbWritten, eof and the conditions */
+static pthread_cond_t space = PTHREAD_COND_INITIALIZER;		/* a slot has been freed */
+static pthread_cond_t work = PTHREAD_COND_INITIALIZER;		/* a position has been queued (or eof) */
+
+
+/* current time, in seconds */
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+
+/* take a position from the queue q (the oldest one), returns -1 if it is empty */
+static long popQueue(t_queue* q) {
+	long i = -1;
+	pthread_mutex_lock(&q->mutex);
+	if (q->nb > 0) {
+		i = q->pos[q->first];
+		q->first = (q->first + 1) % window;
+		q->nb--;
+	}
+	pthread_mutex_unlock(&q->mutex);
+	return i;
+}
+
+
+/* next position for the thread t: from its queue, otherwise stolen from the fullest queue
+ * Returns -1 if there is no more position */
+static long nextPosition(int t) {
+	while (1) {
+		long i = popQueue(&queues[t]);
+		if (i >= 0)
+			return i;
+		int victim = -1;
+		long most = 0;
+		for (int k = 0; k < nbThreads; k++) {
+			long nb = __atomic_load_n(&queues[k].nb, __ATOMIC_RELAXED);
+			if (nb > most) {
+				most = nb;
+				victim = k;
+			}
+		}
+		if (victim >= 0 && (i = popQueue(&queues[victim])) >= 0)
+			return i;
+		/* nothing to do: wait for the reader */
+		pthread_mutex_lock(&mutex);
+		int end = eof;
+		if (!end) {
+			int empty = 1;
+			for (int k = 0; k < nbThreads && empty; k++)
+				empty = __atomic_load_n(&queues[k].nb, __ATOMIC_RELAXED) == 0;
+			if (empty)
+				pthread_cond_wait(&work, &mutex);
+		}
+		pthread_mutex_unlock(&mutex);
+		if (end) {
+			/* the last positions may still be in a queue */
+			for (int k = 0; k < nbThreads; k++)
+				if ((i = popQueue(&queues[k])) >= 0)
+					return i;
+			return -1;
+		}
+	}
+}
+
+
+/* build the position of a line (returns NULL if it is invalid, `newGame` needs sizeX >= 5) */
+static t_game* readPosition(const char* line) {
+	int sizeX, sizeY, nbWalls, n;
+	if (sscanf(line, "%d %d %d%n", &sizeX, &sizeY, &nbWalls, &n) != 3 || sizeX < 5 || sizeY < 1
+		|| sizeX > 1000 || sizeY > 1000 || nbWalls < 0 || nbWalls > 2 * sizeX * sizeY)
+		return NULL;
+	line += n;
+	int* walls = malloc((4 * nbWalls + 1) * sizeof(int));
+	if (!walls)
+		dispError(__FUNCTION__, "Cannot allocate the walls");
+	for (int i = 0; i < 4 * nbWalls; i++) {
+		int x = i % 2 ? sizeY : sizeX;
+		if (sscanf(line, "%d%n", &walls[i], &n) != 1 || walls[i] < 0 || walls[i] >= x) {
+			free(walls);
+			return NULL;
+		}
+		line += n;
+	}
+	t_game* game = newGame(sizeX, sizeY, nbWalls, walls);
+	free(walls);
+
+	/* moves */
+	while (*line == ' ' || *line == '\t')
+		line++;
+	if (*line == '-')
+		line++;
+	for (; *line >= '0' && *line <= '3'; line++)
+		if (playGameMove(game, *line - '0', NULL) != NORMAL_MOVE)
+			break;
+	while (*line == ' ' || *line == '\t' || *line == '\r' || *line == '\n')
+		line++;
+	if (*line) {
+		freeGame(game);
+		return NULL;
+	}
+	return game;
+}
+
+
+/* write the results known, in order, and free their slots */
+static void writeResults() {
+	pthread_mutex_lock(&mutex);
+	int freed = 0;
+	while (nbWritten < __atomic_load_n(&nbRead, __ATOMIC_ACQUIRE)) {
+		t_slot* s = &slots[nbWritten % window];
+		if (!__atomic_load_n(&s->done, __ATOMIC_ACQUIRE))
+			break;
+		fprintf(out, "%s\n", s->result);
+		free(s->line);
+		s->line = NULL;
+		nbWritten++;
+		freed = 1;
+	}
+	if (freed) {
+		fflush(out);
+		pthread_cond_signal(&space);
+	}
+	pthread_mutex_unlock(&mutex);
+}
+
+
+/* thread: evaluate the positions */
+static void* worker(void* arg) {
+	int t = (long) arg;
+	t_bot* bot = NULL;
+	long i, nb = 0;
+	while ((i = nextPosition(t)) >= 0) {
+		t_slot* s = &slots[i % window];
+		t_game* game = readPosition(s->line);
+		t_move legal[4];
+		if (!game)
+			snprintf(s->result, RESULT_SIZE, "- invalid");
+		else if (legalMoves(game, legal) == 0)
+			snprintf(s->result, RESULT_SIZE, "- blocked");
+		else {
+			/* a bot by arena (its tables are only valid for the same size and the same walls) */
+			if (bot && (bot->game->sizeX != game->sizeX || bot->game->sizeY != game->sizeY
+				|| memcmp(bot->game->next, game->next, 4 * game->nbCells * sizeof(int)))) {
+				freeBot(bot);
+				bot = NULL;
+			}
+			if (!bot) {
+				bot = newBot(game, &params);
+				bot->tablebase = tablebase;
+			}
+			t_move move = botMove(bot, game, budget);
+			snprintf(s->result, RESULT_SIZE, "%d %.6g", move, bot->score);
+		}
+		freeGame(game);
+		__atomic_store_n(&s->done, 1, __ATOMIC_RELEASE);
+		writeResults();
+		nb++;
+	}
+	dispDebug(__FUNCTION__, 1, "Thread %d: %ld positions", t, nb);
+	freeBot(bot);
+	return NULL;
+}
+
+
+int main(int argc, char** argv) {
+	const char* outName = NULL;
+	nbThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	window = 0;
+	defaultParams(&params);
+	int opt;
+	while ((opt = getopt(argc, argv, "t:b:v:T:w:o:")) != -1) {
+		switch (opt) {
+			case 't': nbThreads = atoi(optarg); break;
+			case 'b': budget = atof(optarg); break;
+			case 'v':
+				if (readParams(optarg, &params) < 0)
+					dispError(__FUNCTION__, "Cannot read the parameters %s", optarg);
+				break;
+			case 'T':
+				tablebase = tbOpen(optarg);
+				if (!tablebase)
+					dispError(__FUNCTION__, "Cannot read the tablebase %s", optarg);
+				break;
+			case 'w': window = atol(optarg); break;
+			case 'o': outName = optarg; break;
+			default:
+				fprintf(stderr, "Usage: %s [-t threads] [-b budget] [-v params] [-T tablebase] [-w window] [-o output] [input]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+	if (nbThreads < 1)
+		nbThreads = 1;
+	if (window < 1)
+		window = WINDOW_BY_THREAD * nbThreads;
+	FILE* in = optind < argc ? fopen(argv[optind], "r") : stdin;
+	if (!in)
+		dispError(__FUNCTION__, "Cannot open %s", argv[optind]);
+	out = outName ? fopen(outName, "w") : stdout;
+	if (!out)
+		dispError(__FUNCTION__, "Cannot open %s", outName);
+
+	slots = calloc(window, sizeof(t_slot));
+	queues = calloc(nbThreads, sizeof(t_queue));
+	pthread_t* threads = malloc(nbThreads * sizeof(pthread_t));
+	if (!slots || !queues || !threads)
+		dispError(__FUNCTION__, "Cannot allocate the window");
+	for (int k = 0; k < nbThreads; k++) {
+		pthread_mutex_init(&queues[k].mutex, NULL);
+		queues[k].pos = malloc(window * sizeof(long));
+		if (!queues[k].pos)
+			dispError(__FUNCTION__, "Cannot allocate the queues");
+	}
+	double start = now();
+	for (long k = 0; k < nbThreads; k++)
+		if (pthread_create(&threads[k], NULL, worker, (void*) k))
+			dispError(__FUNCTION__, "Cannot create a thread");
+
+	/* read the positions, and give them to the threads in turn */
+	char* line = NULL;
+	size_t size = 0;
+	while (getline(&line, &size, in) >= 0) {
+		if (line[strspn(line, " \t\r\n")] == 0 || line[0] == '#')
+			continue;
+		/* wait for a free slot */
+		pthread_mutex_lock(&mutex);
+		while (nbRead - nbWritten >= window)
+			pthread_cond_wait(&space, &mutex);
+		pthread_mutex_unlock(&mutex);
+
+		long i = nbRead;
+		t_slot* s = &slots[i % window];
+		s->line = strdup(line);
+		if (!s->line)
+			dispError(__FUNCTION__, "Cannot allocate the position");
+		s->done = 0;
+		__atomic_store_n(&nbRead, i + 1, __ATOMIC_RELEASE);
+		t_queue* q = &queues[i % nbThreads];
+		pthread_mutex_lock(&q->mutex);
+		q->pos[(q->first + q->nb) % window] = i;
+		q->nb++;
+		pthread_mutex_unlock(&q->mutex);
+		pthread_mutex_lock(&mutex);
+		pthread_cond_signal(&work);
+		pthread_mutex_unlock(&mutex);
+	}
+	free(line);
+	pthread_mutex_lock(&mutex);
+	eof = 1;
+	pthread_cond_broadcast(&work);
+	pthread_mutex_unlock(&mutex);
+
+	for (int k = 0; k < nbThreads; k++)
+		pthread_join(threads[k], NULL);
+	writeResults();
+	double t = now() - start;
+	fprintf(stderr, "%ld positions in %.1fs (%.1f positions/s)\n", nbRead, t, nbRead / t);
+
+	for (int k = 0; k < nbThreads; k++) {
+		pthread_mutex_destroy(&queues[k].mutex);
+		free(queues[k].pos);
+	}
+	free(queues);
+	free(slots);
+	free(threads);
+	tbFree(tablebase);
+	if (in != stdin)
+		fclose(in);
+	if (out != stdout)
+		fclose(out);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,292 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: cgsLoad.c
+	Load generator: opens a lot of simultaneous connections to a server (the real one,
+	or cgsServer), with the functions of clientAPI.c (one thread per connection),
+	and plays random legal moves.
+	It reports the number of moves per second, the latencies (percentiles) of the commands
+	and the memory used by each connection
+
+	It must be compiled with -DCGS_THREADED (so that each thread has its own connection):
+	gcc -O2 -DCGS_THREADED cgsLoad.c clientAPI.c snakeGame.c arenaGen.c -pthread -lm -o cgsLoad
+
+	Usage: cgsLoad [-s server] [-p port] [-c connections] [-n games] [-g gameType] [-d]
+	  -s, -p: server and port (localhost:1234 by default)
+	  -c: number of connections (1000 by default)
+	  -n: number of games played by each connection (5 by default)
+	  -g: gameType (the connections 2k and 2k+1 play together, except for "TRAINING <BOT>")
+	  -d: ask the server to display the arena at the end of each game (DISP_GAME)
+	The report is written on stderr (the API prints the end of each game on stdout)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include "clientAPI.h"
+#include "arenaGen.h"
+
+#ifndef CGS_THREADED
+#error "cgsLoad must be compiled with -DCGS_THREADED"
+#endif
+
+
+#define STACK_SIZE (256 * 1024)	/* stack of the threads (it also contains the buffers of clientAPI.c) */
+#define NB_BUCKETS 256			/* histogram of the latencies: 8 buckets per power of 2 of nanoseconds */
+#define BUCKET_RES 8
+
+
+/* latencies of a type of command */
+typedef struct {
+	long count[NB_BUCKETS];
+	long nb;
+	double max;
+} t_histo;
+
+enum {
+	H_PLAY,			/* PLAY_MOVE */
+	H_GET,			/* GET_MOVE (includes the time the opponent takes to play) */
+	H_WAIT,			/* WAIT_GAME and GET_GAME_DATA */
+	H_OTHER,		/* SEND_COMMENT and DISP_GAME */
+	NB_HISTO
+};
+static const char* histoName[NB_HISTO] = {"PLAY_MOVE", "GET_MOVE", "WAIT_GAME", "COMMENT/DISP"};
+
+
+/* options and results shared by the threads */
+static const char* serverName = "localhost";
+static int port = 1234;
+static int nbGames = 5;
+static const char* gameType = "difficulty=2";
+static int display = 0;
+static pthread_barrier_t connected;
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static t_histo histo[NB_HISTO];
+static long nbMoves = 0, nbGamesPlayed = 0;
+
+
+/* current time, in seconds */
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+
+/* resident memory of the process (in bytes) */
+static long residentMemory() {
+	long size, resident = 0;
+	FILE* f = fopen("/proc/self/statm", "r");
+	if (f) {
+		if (fscanf(f, "%ld %ld", &size, &resident) != 2)
+			resident = 0;
+		fclose(f);
+	}
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+
+/* add a latency (in seconds) to a histogram */
+static void addLatency(t_histo* h, double t) {
+	double ns = t * 1e9;
+	int b = ns < 1 ? 0 : (int) (log2(ns) * BUCKET_RES);
+	h->count[b < NB_BUCKETS ? b : NB_BUCKETS - 1]++;
+	h->nb++;
+	if (t > h->max)
+		h->max = t;
+}
+
+
+/* latency (in seconds) of the percentile q of a histogram (upper bound of its bucket) */
+static double percentile(const t_histo* h, double q) {
+	long k = (long) ceil(q * h->nb), sum = 0;
+	for (int b = 0; b < NB_BUCKETS; b++) {
+		sum += h->count[b];
+		if (sum >= k && sum > 0)
+			return fmin(exp2((b + 1.0) / BUCKET_RES) * 1e-9, h->max);
+	}
+	return h->max;
+}
+
+
+/* thread: one connection, that plays nbGames games */
+static void* client(void* arg) {
+	long id = (long) arg;
+	t_histo local[NB_HISTO];
+	memset(local, 0, sizeof(local));
+	unsigned long long random = id;
+	long moves = 0;
+	char name[21], type[151], gameName[51], data[128];
+	char move[MAX_GET_MOVE], msg[MAX_MESSAGE];
+	snprintf(name, sizeof(name), "load%ld", id);
+	/* the connections play by pair (the unknown key is ignored by the server) */
+	if (strncmp(gameType, "TRAINING", 8) == 0)
+		snprintf(type, sizeof(type), "%s", gameType);
+	else
+		snprintf(type, sizeof(type), "%s pair=%ld", gameType, id / 2);
+
+	connectToCGS(__FUNCTION__, serverName, port, name);
+	pthread_barrier_wait(&connected);
+
+	for (int g = 0; g < nbGames; g++) {
+		double t = now();
+		int sizeX, sizeY, nbWalls;
+		waitForGame(__FUNCTION__, type, gameName, data);
+		sscanf(data, "%d %d %d", &sizeX, &sizeY, &nbWalls);
+		char* wallData = malloc(44 * nbWalls + 64);
+		int* walls = malloc(4 * (nbWalls + 1) * sizeof(int));
+		if (!wallData || !walls)
+			dispError(__FUNCTION__, "Cannot allocate the walls");
+		int start = getGameData(__FUNCTION__, wallData, 44 * nbWalls + 64);
+		addLatency(&local[H_WAIT], now() - t);
+		char* p = wallData;
+		int n;
+		for (int i = 0; i < nbWalls; i++) {
+			sscanf(p, "%d %d %d %d%n", walls + 4 * i, walls + 4 * i + 1, walls + 4 * i + 2, walls + 4 * i + 3, &n);
+			p += n;
+		}
+		t_game* game = newGame(sizeX, sizeY, nbWalls, walls);
+		free(walls);
+		free(wallData);
+
+		t = now();
+		sendCGSComment(__FUNCTION__, "Hello");
+		addLatency(&local[H_OTHER], now() - t);
+
+		/* we are the player 0 if we start */
+		int ret = NORMAL_MOVE;
+		while (ret == NORMAL_MOVE) {
+			t_move legal[4];
+			t = now();
+			if (game->turn % 2 == start) {
+				int nb = legalMoves(game, legal);
+				t_move m = nb ? legal[nextRandom(&random) % nb] : NORTH;
+				sprintf(move, "%d", m);
+				ret = sendCGSMove(__FUNCTION__, move, msg);
+				addLatency(&local[H_PLAY], now() - t);
+				moves++;
+				if (ret == NORMAL_MOVE)
+					playGameMove(game, m, NULL);
+			}
+			else {
+				int m;
+				ret = getCGSMove(__FUNCTION__, move, msg);
+				addLatency(&local[H_GET], now() - t);
+				if (ret == NORMAL_MOVE && (sscanf(move, "%d", &m) != 1 || playGameMove(game, m, NULL) != NORMAL_MOVE))
+					dispError(__FUNCTION__, "Invalid move %s from the server", move);
+			}
+		}
+		freeGame(game);
+
+		if (display) {
+			t = now();
+			printCGSGame(__FUNCTION__);
+			addLatency(&local[H_OTHER], now() - t);
+		}
+	}
+	closeCGSConnection(__FUNCTION__);
+
+	/* merge the results */
+	pthread_mutex_lock(&mutex);
+	for (int h = 0; h < NB_HISTO; h++) {
+		for (int b = 0; b < NB_BUCKETS; b++)
+			histo[h].count[b] += local[h].count[b];
+		histo[h].nb += local[h].nb;
+		if (local[h].max > histo[h].max)
+			histo[h].max = local[h].max;
+	}
+	nbMoves += moves;
+	nbGamesPlayed += nbGames;
+	pthread_mutex_unlock(&mutex);
+	return NULL;
+}
+
+
+int main(int argc, char** argv) {
+	int nbConn = 1000;
+	int opt;
+	while ((opt = getopt(argc, argv, "s:p:c:n:g:d")) != -1) {
+		switch (opt) {
+			case 's': serverName = optarg; break;
+			case 'p': port = atoi(optarg); break;
+			case 'c': nbConn = atoi(optarg); break;
+			case 'n': nbGames = atoi(optarg); break;
+			case 'g': gameType = optarg; break;
+			case 'd': display = 1; break;
+			default:
+				fprintf(stderr, "Usage: %s [-s server] [-p port] [-c connections] [-n games] [-g gameType] [-d]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+	/* the connections play by pair */
+	if (strncmp(gameType, "TRAINING", 8) != 0 && nbConn % 2)
+		nbConn++;
+	if (nbConn < 1)
+		dispError(__FUNCTION__, "Invalid number of connections");
+
+	struct rlimit lim;
+	if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+		lim.rlim_cur = lim.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &lim);
+	}
+
+	pthread_t* threads = malloc(nbConn * sizeof(pthread_t));
+	if (!threads)
+		dispError(__FUNCTION__, "Cannot allocate the threads");
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, STACK_SIZE);
+	pthread_barrier_init(&connected, NULL, nbConn + 1);
+
+	/* open all the connections, and measure the memory they use */
+	long mem = residentMemory();
+	double t0 = now();
+	for (long i = 0; i < nbConn; i++)
+		if (pthread_create(&threads[i], &attr, client, (void*) i))
+			dispError(__FUNCTION__, "Cannot create the thread %ld", i);
+	pthread_barrier_wait(&connected);
+	double t1 = now();
+	mem = residentMemory() - mem;
+	fprintf(stderr, "%d connections opened in %.2fs, %ld bytes/connection (resident memory)\n",
+		nbConn, t1 - t0, mem / nbConn);
+
+	for (int i = 0; i < nbConn; i++)
+		pthread_join(threads[i], NULL);
+	double t = now() - t1;
+
+	fprintf(stderr, "%ld games, %ld moves in %.2fs: %.0f moves/s, %.1f games/s\n",
+		nbGamesPlayed / (strncmp(gameType, "TRAINING", 8) ? 2 : 1), nbMoves, t, nbMoves / t,
+		nbGamesPlayed / (strncmp(gameType, "TRAINING", 8) ? 2 : 1) / t);
+	fprintf(stderr, "latencies (ms)       count      p50      p90      p99    p99.9      max\n");
+	for (int h = 0; h < NB_HISTO; h++)
+		if (histo[h].nb)
+			fprintf(stderr, "%-15s %10ld %8.3f %8.3f %8.3f %8.3f %8.3f\n", histoName[h], histo[h].nb,
+				1e3 * percentile(&histo[h], 0.5), 1e3 * percentile(&histo[h], 0.9),
+				1e3 * percentile(&histo[h], 0.99), 1e3 * percentile(&histo[h], 0.999), 1e3 * histo[h].max);
+
+	pthread_barrier_destroy(&connected);
+	pthread_attr_destroy(&attr);
+	free(threads);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,624 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: cgsServer.c
+	Local stand-in for the Coding Game Server (single thread, epoll), speaking
+	the protocol of clientAPI.c, to test the bots and measure the transport under load
+
+	Each answer is sent with a header of 6 characters giving its length. The commands are
+	buffered by connection: a command ends with a newline, so that several commands can come
+	in one read or a command in several reads. clientAPI.c sends no newline: until a connection
+	has sent a newline, a command ends with the data available (clientAPI.c sends a command
+	in one write, and waits for the answers before sending the next one)
+	- CLIENT_NAME name -> OK
+	- WAIT_GAME gameType -> OK, NOT_READY (every second, while there is no opponent), game name, "sizeX sizeY nbWalls"
+	  "TRAINING <BOT>" plays against a random player of the server,
+	  otherwise the clients with the same gameType are paired
+	- GET_GAME_DATA -> OK, walls, who starts (0 or 1)
+	- PLAY_MOVE move -> OK, message, return code
+	- GET_MOVE -> OK (then when the opponent has played) move, message, return code
+	- DISP_GAME -> OK, the arena
+	- SEND_COMMENT comment -> OK
+	The arenas are generated locally (arenaGen.h) from the options of the gameType, the timeout is ignored
+
+	Usage: cgsServer [-p port] [-s period]
+	  -p: port (1234 by default)
+	  -s: period (in seconds) of the statistics (10 by default, 0 for none)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "clientAPI.h"
+#include "arenaGen.h"
+
+
+#define HEAD_SIZE 6				/* number of bytes of the header (size of the message) */
+#define IN_SIZE 256				/* maximal size of a command */
+#define NOT_READY_PERIOD 1.0	/* period of the NOT_READY messages sent to the waiting clients (in seconds) */
+#define MAX_EVENTS 256
+
+
+/* state of a connection */
+enum {
+	CONN_NEW,			/* waiting for CLIENT_NAME */
+	CONN_IDLE,			/* connected, not in a game */
+	CONN_WAITING,		/* waiting for an opponent */
+	CONN_PLAYING		/* in a game (may be over) */
+};
+
+typedef struct s_match t_match;
+
+/* A connection */
+typedef struct s_conn {
+	int fd;
+	int state;
+	char name[21];
+	char gameType[151];
+	char in[IN_SIZE];			/* commands received and not executed yet */
+	size_t nbIn;
+	int framed;					/* 1 once the client has ended a command with a newline */
+	char* out;					/* answers not sent yet */
+	size_t nbOut, sizeOut, sent;
+	int epollOut;				/* 1 if we wait for EPOLLOUT */
+	t_match* match;
+	int player;					/* our player in the match */
+	int getMove;				/* 1 if a GET_MOVE is pending */
+	struct s_conn *prev, *next;	/* list of the waiting connections */
+} t_conn;
+
+/* A match between two connections (or a connection and the random player) */
+struct s_match {
+	t_game* game;
+	char name[51];
+	t_conn* conn[2];			/* conn[p] plays for the player p (NULL for the random player) */
+	char* walls;				/* walls, as sent to the clients */
+	int nbWalls;
+	int played[2];				/* number of moves sent by each player */
+	int delivered[2];			/* number of moves of the opponent given to each player */
+	int lastMove[2];			/* last move of each player, its return code (relative to the player) and message */
+	int lastRet[2];
+	const char* lastMsg[2];
+	int over;
+	unsigned long long random;	/* state of the random player */
+};
+
+
+/* the server */
+static int epfd;
+static t_conn* waiting = NULL;	/* list of the waiting connections */
+static unsigned long long seedState = 0x434753;
+static long nbConnections = 0, nbMatches = 0, nbMatchesDone = 0, nbMoves = 0, nbCommands = 0;
+
+
+/* current time, in seconds */
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+
+/* resident memory of the process (in bytes) */
+static long residentMemory() {
+	long size, resident = 0;
+	FILE* f = fopen("/proc/self/statm", "r");
+	if (f) {
+		if (fscanf(f, "%ld %ld", &size, &resident) != 2)
+			resident = 0;
+		fclose(f);
+	}
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+
+/* queue a message (with its header) in the output buffer of a connection */
+static void sendData(t_conn* c, const char* msg, size_t n) {
+	size_t size = c->nbOut + HEAD_SIZE + n + 1;
+	if (size > c->sizeOut) {
+		c->sizeOut = size < 2 * c->sizeOut ? 2 * c->sizeOut : size;
+		c->out = realloc(c->out, c->sizeOut);
+		if (!c->out)
+			dispError(__FUNCTION__, "Cannot allocate the output buffer");
+	}
+	char head[32];
+	snprintf(head, sizeof(head), "%-6zu", n);
+	memcpy(c->out + c->nbOut, head, HEAD_SIZE);
+	memcpy(c->out + c->nbOut + HEAD_SIZE, msg, n);
+	c->nbOut += HEAD_SIZE + n;
+}
+
+
+/* same, with a formatted message (max MAX_MESSAGE characters) */
+static void sendMsg(t_conn* c, const char* msg, ...) {
+	char tmp[MAX_MESSAGE];
+	va_list args;
+	va_start(args, msg);
+	int n = vsnprintf(tmp, sizeof(tmp), msg, args);
+	va_end(args);
+	sendData(c, tmp, n < (int) sizeof(tmp) ? n : (int) sizeof(tmp) - 1);
+}
+
+
+/* write what we can of the output buffer (and wait for EPOLLOUT if needed) */
+static void flush(t_conn* c) {
+	while (c->sent < c->nbOut) {
+		ssize_t r = write(c->fd, c->out + c->sent, c->nbOut - c->sent);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				c->sent = c->nbOut;		/* the connection is broken, EPOLLIN will tell it */
+			break;
+		}
+		c->sent += r;
+	}
+	if (c->sent == c->nbOut)
+		c->sent = c->nbOut = 0;
+	int wantOut = c->nbOut > 0;
+	if (wantOut != c->epollOut) {
+		struct epoll_event ev = {.events = EPOLLIN | (wantOut ? EPOLLOUT : 0), .data.ptr = c};
+		epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd, &ev);
+		c->epollOut = wantOut;
+	}
+}
+
+
+/* remove a connection from the waiting list */
+static void unWait(t_conn* c) {
+	if (c->prev)
+		c->prev->next = c->next;
+	else
+		waiting = c->next;
+	if (c->next)
+		c->next->prev = c->prev;
+	c->prev = c->next = NULL;
+}
+
+
+/* give the opponent's move to the player p if it has asked it and if it is available */
+static void deliverMove(t_match* m, int p) {
+	t_conn* c = m->conn[p];
+	int q = 1 - p;
+	if (!c || !c->getMove || m->played[q] <= m->delivered[p])
+		return;
+	/* the return code is relative to the opponent */
+	sendMsg(c, "%d", m->lastMove[q]);
+	sendMsg(c, "%s", m->lastMsg[q]);
+	sendMsg(c, "%d", m->lastRet[q]);
+	m->delivered[p] = m->played[q];
+	c->getMove = 0;
+	flush(c);
+}
+
+
+/* play a move for the player p, and returns its return code */
+static int playMatchMove(t_match* m, int p, int move) {
+	t_game* game = m->game;
+	int ret;
+	const char* msg;
+	if (m->over) {
+		ret = LOSING_MOVE;
+		msg = "The game is over";
+	}
+	else if (game->turn % 2 != p) {
+		ret = LOSING_MOVE;
+		msg = "It was not your turn";
+	}
+	else if (move < NORTH || move > WEST || playGameMove(game, move, NULL) != NORMAL_MOVE) {
+		ret = LOSING_MOVE;
+		msg = "Illegal move";
+	}
+	else {
+		t_move moves[4];
+		if (legalMoves(game, moves) == 0) {
+			ret = WINNING_MOVE;
+			msg = "The opponent is blocked";
+		}
+		else {
+			ret = NORMAL_MOVE;
+			msg = "";
+		}
+	}
+	if (!m->over && ret != NORMAL_MOVE) {
+		m->over = 1;
+		nbMatchesDone++;
+	}
+	m->lastMove[p] = move;
+	m->lastRet[p] = ret;
+	m->lastMsg[p] = msg;
+	m->played[p]++;
+	nbMoves++;
+	return ret;
+}
+
+
+/* the random player plays (if it is its turn) */
+static void randomPlayer(t_match* m) {
+	for (int p = 0; p < 2; p++)
+		if (!m->conn[p] && !m->over && m->game->turn % 2 == p) {
+			t_move moves[4];
+			int nb = legalMoves(m->game, moves);
+			playMatchMove(m, p, nb ? moves[nextRandom(&m->random) % nb] : NORTH);
+			deliverMove(m, 1 - p);
+		}
+}
+
+
+/* create a match between two connections (c2 can be NULL for the random player) */
+static void newMatch(t_conn* c1, t_conn* c2) {
+	t_gameOptions opt;
+	if (parseGameType(c1->gameType, &opt) < 0)
+		dispDebug(__FUNCTION__, 1, "Invalid options in \"%s\" (default values used)", c1->gameType);
+	if (opt.seed < 0)
+		opt.seed = nextRandom(&seedState) & 0xFFFFFF;
+	if (opt.start < 0)
+		opt.start = nextRandom(&seedState) & 1;
+
+	t_match* m = calloc(1, sizeof(t_match));
+	if (!m)
+		dispError(__FUNCTION__, "Cannot allocate the match");
+	m->game = generateArena(&opt);
+	int* walls = malloc(8 * m->game->nbCells * sizeof(int));
+	m->walls = malloc(44 * 2 * m->game->nbCells + 1);
+	if (!walls || !m->walls)
+		dispError(__FUNCTION__, "Cannot allocate the walls");
+	m->nbWalls = arenaWalls(m->game, walls);
+	char* p = m->walls;
+	*p = 0;
+	for (int i = 0; i < m->nbWalls; i++)
+		p += sprintf(p, "%d %d %d %d ", walls[4 * i], walls[4 * i + 1], walls[4 * i + 2], walls[4 * i + 3]);
+	free(walls);
+	m->random = opt.seed;
+	snprintf(m->name, sizeof(m->name), "LOCAL_%ld_%06lx", nbMatches, opt.seed & 0xFFFFFF);
+	nbMatches++;
+
+	/* start=0 means that the first player (the one that waited) begins */
+	m->conn[opt.start] = c1;
+	m->conn[1 - opt.start] = c2;
+	for (int i = 0; i < 2; i++) {
+		t_conn* c = m->conn[i];
+		if (!c)
+			continue;
+		c->state = CONN_PLAYING;
+		c->match = m;
+		c->player = i;
+		c->getMove = 0;
+		sendMsg(c, "%s", m->name);
+		sendMsg(c, "%d %d %d", m->game->sizeX, m->game->sizeY, m->nbWalls);
+		flush(c);
+	}
+	dispDebug(__FUNCTION__, 1, "Game %s: %s vs %s", m->name, m->conn[0] ? m->conn[0]->name : "RANDOM_PLAYER",
+		m->conn[1] ? m->conn[1]->name : "RANDOM_PLAYER");
+	randomPlayer(m);
+}
+
+
+/* a connection leaves its match (the match is freed when nobody is in it) */
+static void leaveMatch(t_conn* c) {
+	t_match* m = c->match;
+	if (!m)
+		return;
+	int p = c->player;
+	if (!m->over) {
+		/* the connection abandons: the opponent wins */
+		m->over = 1;
+		nbMatchesDone++;
+		m->lastMove[p] = 0;
+		m->lastRet[p] = LOSING_MOVE;
+		m->lastMsg[p] = "The opponent has left";
+		m->played[p]++;
+		deliverMove(m, 1 - p);
+	}
+	m->conn[p] = NULL;
+	c->match = NULL;
+	c->state = CONN_IDLE;
+	if (!m->conn[0] && !m->conn[1]) {
+		freeGame(m->game);
+		free(m->walls);
+		free(m);
+	}
+}
+
+
+/* draw the arena (walls, bodies and heads) */
+static void dispGame(t_conn* c) {
+	t_match* m = c->match;
+	if (!m) {
+		sendMsg(c, "No game\n");
+		return;
+	}
+	t_game* game = m->game;
+	int w = 2 * game->sizeX + 2;
+	size_t n = (size_t) w * (2 * game->sizeY + 1) + 128;
+	char* s = malloc(n);
+	if (!s)
+		dispError(__FUNCTION__, "Cannot allocate the display");
+	int k = snprintf(s, 128, "Game %s, turn %d\n", m->name, game->turn);
+	char* grid = s + k;
+	for (int y = 0; y <= 2 * game->sizeY; y++) {
+		for (int x = 0; x <= 2 * game->sizeX; x++)
+			grid[y * w + x] = (x % 2 == 0 && y % 2 == 0) ? '+' : ' ';
+		grid[y * w + w - 1] = '\n';
+	}
+	for (int y = 0; y < game->sizeY; y++)
+		for (int x = 0; x < game->sizeX; x++) {
+			int cell = CELL(game, x, y);
+			char* g = grid + (2 * y + 1) * w + 2 * x + 1;
+			int occ = game->occupied[cell];
+			*g = occ ? (cell == snakeHead(game, occ - 1) ? 'A' + occ - 1 : '0' + occ - 1) : '.';
+			if (game->next[4 * cell + NORTH] < 0)
+				g[-w] = '-';
+			if (game->next[4 * cell + SOUTH] < 0)
+				g[w] = '-';
+			if (game->next[4 * cell + WEST] < 0)
+				g[-1] = '|';
+			if (game->next[4 * cell + EAST] < 0)
+				g[1] = '|';
+		}
+	sendData(c, s, k + (size_t) w * (2 * game->sizeY + 1));
+	free(s);
+}
+
+
+/* close a connection */
+static void closeConn(t_conn* c) {
+	dispDebug(__FUNCTION__, 2, "Close connection %s", c->name);
+	if (c->state == CONN_WAITING)
+		unWait(c);
+	leaveMatch(c);
+	epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+	close(c->fd);
+	free(c->out);
+	free(c);
+	nbConnections--;
+}
+
+
+/* execute a command of a connection */
+static void command(t_conn* c, char* cmd) {
+	nbCommands++;
+	dispDebug(__FUNCTION__, 3, "Receive '%s' from %s", cmd, c->name);
+	char* arg = strchr(cmd, ' ');
+	if (arg)
+		*arg++ = 0;
+	else
+		arg = cmd + strlen(cmd);
+
+	if (strcmp(cmd, "CLIENT_NAME") == 0 && c->state == CONN_NEW) {
+		snprintf(c->name, sizeof(c->name), "%s", arg);
+		c->state = CONN_IDLE;
+		sendMsg(c, "OK");
+	}
+	else if (c->state == CONN_NEW)
+		sendMsg(c, "You must send your name first (CLIENT_NAME)");
+	else if (strcmp(cmd, "WAIT_GAME") == 0 && c->state != CONN_WAITING) {
+		leaveMatch(c);
+		snprintf(c->gameType, sizeof(c->gameType), "%s", arg);
+		sendMsg(c, "OK");
+		if (strncmp(arg, "TRAINING", 8) == 0)
+			newMatch(c, NULL);
+		else {
+			/* look for an opponent with the same gameType, otherwise wait */
+			t_conn* o = waiting;
+			while (o && strcmp(o->gameType, c->gameType) != 0)
+				o = o->next;
+			if (o) {
+				unWait(o);
+				newMatch(o, c);
+			}
+			else {
+				c->state = CONN_WAITING;
+				c->next = waiting;
+				if (waiting)
+					waiting->prev = c;
+				waiting = c;
+			}
+		}
+	}
+	else if (strcmp(cmd, "GET_GAME_DATA") == 0 && c->match) {
+		sendMsg(c, "OK");
+		sendData(c, c->match->walls, strlen(c->match->walls));
+		sendMsg(c, "%d", c->player);
+	}
+	else if (strcmp(cmd, "PLAY_MOVE") == 0 && c->match) {
+		t_match* m = c->match;
+		char* end;
+		long move = strtol(arg, &end, 10);
+		if (end == arg)
+			move = -1;
+		int ret = playMatchMove(m, c->player, move);
+		sendMsg(c, "OK");
+		sendMsg(c, "%s", m->lastMsg[c->player]);
+		sendMsg(c, "%d", ret);
+		flush(c);
+		deliverMove(m, 1 - c->player);
+		randomPlayer(m);
+	}
+	else if (strcmp(cmd, "GET_MOVE") == 0 && c->match) {
+		sendMsg(c, "OK");
+		c->getMove = 1;
+		deliverMove(c->match, c->player);
+	}
+	else if (strcmp(cmd, "DISP_GAME") == 0) {
+		sendMsg(c, "OK");
+		dispGame(c);
+	}
+	else if (strcmp(cmd, "SEND_COMMENT") == 0) {
+		dispDebug(__FUNCTION__, 2, "%s says: %s", c->name, arg);
+		sendMsg(c, "OK");
+	}
+	else
+		sendMsg(c, "Unknown (or unexpected) command %s", cmd);
+	flush(c);
+}
+
+
+/* accept the new connections */
+static void acceptConn(int listenfd) {
+	int fd;
+	while ((fd = accept(listenfd, NULL, NULL)) >= 0) {
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		t_conn* c = calloc(1, sizeof(t_conn));
+		if (!c)
+			dispError(__FUNCTION__, "Cannot allocate the connection");
+		c->fd = fd;
+		c->state = CONN_NEW;
+		strcpy(c->name, "?");
+		struct epoll_event ev = {.events = EPOLLIN, .data.ptr = c};
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+			dispError(__FUNCTION__, "Cannot add the connection to epoll");
+		nbConnections++;
+	}
+}
+
+
+/* execute the first n bytes of the input buffer as a command, and remove them (and the delimiter) */
+static void nextCommand(t_conn* c, size_t n, size_t delim) {
+	c->in[n] = 0;
+	if (n > 0 && c->in[n - 1] == '\r')
+		c->in[n - 1] = 0;
+	if (c->in[0])
+		command(c, c->in);
+	c->nbIn -= n + delim;
+	memmove(c->in, c->in + n + delim, c->nbIn);
+}
+
+
+/* read the commands of a connection: the complete lines are executed as they come; for a client
+ * that does not use newlines (clientAPI.c), what remains when no more data is available is a command */
+static void readConn(t_conn* c) {
+	while (1) {
+		ssize_t r = read(c->fd, c->in + c->nbIn, IN_SIZE - 1 - c->nbIn);
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (r <= 0) {
+			closeConn(c);
+			return;
+		}
+		c->nbIn += r;
+		char* nl;
+		while ((nl = memchr(c->in, '\n', c->nbIn))) {
+			c->framed = 1;
+			nextCommand(c, nl - c->in, 1);
+		}
+		/* a command too long is cut */
+		if (c->nbIn == IN_SIZE - 1)
+			nextCommand(c, c->nbIn, 0);
+	}
+	if (c->nbIn > 0 && !c->framed)
+		nextCommand(c, c->nbIn, 0);
+}
+
+
+int main(int argc, char** argv) {
+	int port = 1234;
+	double period = 10;
+	int opt;
+	while ((opt = getopt(argc, argv, "p:s:")) != -1) {
+		switch (opt) {
+			case 'p': port = atoi(optarg); break;
+			case 's': period = atof(optarg); break;
+			default:
+				fprintf(stderr, "Usage: %s [-p port] [-s period]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+	signal(SIGPIPE, SIG_IGN);
+
+	/* as many connections as possible */
+	struct rlimit lim;
+	if (getrlimit(RLIMIT_NOFILE, &lim) == 0) {
+		lim.rlim_cur = lim.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &lim);
+	}
+
+	int listenfd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenfd < 0)
+		dispError(__FUNCTION__, "Impossible to open socket");
+	int one = 1;
+	setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_ANY)};
+	if (bind(listenfd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(listenfd, SOMAXCONN) < 0)
+		dispError(__FUNCTION__, "Cannot listen on port %d", port);
+	fcntl(listenfd, F_SETFL, O_NONBLOCK);
+
+	epfd = epoll_create1(0);
+	struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+	if (epfd < 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, listenfd, &ev) < 0)
+		dispError(__FUNCTION__, "Cannot create the epoll instance");
+	printf("Listening on port %d\n", port);
+	fflush(stdout);
+
+	long memStart = residentMemory(), lastMoves = 0;
+	double lastNotReady = now(), lastStats = now();
+	struct epoll_event events[MAX_EVENTS];
+	while (1) {
+		int n = epoll_wait(epfd, events, MAX_EVENTS, 100);
+		if (n < 0 && errno != EINTR)
+			dispError(__FUNCTION__, "epoll_wait failed");
+		for (int i = 0; i < n; i++) {
+			t_conn* c = events[i].data.ptr;
+			if (!c)
+				acceptConn(listenfd);
+			else if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+				readConn(c);
+			else if (events[i].events & EPOLLOUT)
+				flush(c);
+		}
+
+		/* the waiting clients are polled, to detect the disconnections */
+		double t = now();
+		if (t - lastNotReady >= NOT_READY_PERIOD) {
+			t_conn* c = waiting;
+			while (c) {
+				t_conn* next = c->next;
+				sendMsg(c, "NOT_READY");
+				flush(c);
+				c = next;
+			}
+			lastNotReady = t;
+		}
+		if (period > 0 && t - lastStats >= period) {
+			long mem = residentMemory() - memStart;
+			printf("%ld connections, %ld games (%ld over), %.0f moves/s, %ld commands, %ld bytes/connection\n",
+				nbConnections, nbMatches, nbMatchesDone, (nbMoves - lastMoves) / (t - lastStats), nbCommands,
+				nbConnections ? mem / nbConnections : 0);
+			fflush(stdout);
+			lastMoves = nbMoves;
+			lastStats = t;
+		}
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,482 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: chamber.c
+	Chamber (biconnected components) decomposition of the free cells,
+	used to estimate the longest path a snake can fill
+
+	The decomposition is computed with the (iterative) Tarjan algorithm.
+	When a cell becomes occupied, only the chambers containing it are decomposed again;
+	when a cell is freed, it is added to the chamber of its neighbours (or makes a new chamber)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "clientAPI.h"
+#include "chamber.h"
+
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+
+
+/* add/remove the chamber id to the list of chambers of the cell c */
+static void addCellChamber(t_chambers* ch, int c, int id) {
+	int* s = ch->cellCh + 4 * c;
+	for (int i = 0; i < 4; i++)
+		if (s[i] < 0) {
+			s[i] = id;
+			return;
+		}
+	dispError(__FUNCTION__, "A cell cannot belong to more than 4 chambers (cell %d)", c);
+}
+
+static void removeCellChamber(t_chambers* ch, int c, int id) {
+	int* s = ch->cellCh + 4 * c;
+	for (int i = 0; i < 4; i++)
+		if (s[i] == id)
+			s[i] = -1;
+}
+
+
+/* number of chambers containing the cell c (at least 2 for an articulation point) */
+static int nbCellChambers(const t_chambers* ch, int c) {
+	const int* s = ch->cellCh + 4 * c;
+	return (s[0] >= 0) + (s[1] >= 0) + (s[2] >= 0) + (s[3] >= 0);
+}
+
+
+/* first chamber containing the cell c (-1 if none) */
+static int firstCellChamber(const t_chambers* ch, int c) {
+	const int* s = ch->cellCh + 4 * c;
+	for (int i = 0; i < 4; i++)
+		if (s[i] >= 0)
+			return s[i];
+	return -1;
+}
+
+
+/* indicates if the cell c belongs to the chamber id */
+static int inChamber(const t_chambers* ch, int c, int id) {
+	const int* s = ch->cellCh + 4 * c;
+	return s[0] == id || s[1] == id || s[2] == id || s[3] == id;
+}
+
+
+/* Create a new chamber with the n cells and the extra cell (if extra>=0)
+ * Returns its id, or -1 if the arrays are full (the overflow flag is then set) */
+static int emitChamber(t_chambers* ch, const int* cells, int n, int extra) {
+	int size = n + (extra >= 0);
+	if (ch->nbCh == ch->capCh || ch->nbMembers + size > ch->capMembers) {
+		ch->overflow = 1;
+		return -1;
+	}
+	int id = ch->nbCh++;
+	t_chamber* C = &ch->ch[id];
+	C->start = ch->nbMembers;
+	C->size = size;
+	C->black = 0;
+	for (int i = 0; i < size; i++) {
+		int c = i < n ? cells[i] : extra;
+		ch->members[ch->nbMembers++] = c;
+		C->black += ((c % ch->sizeX) + (c / ch->sizeX)) % 2 == 0;
+		addCellChamber(ch, c, id);
+	}
+	return id;
+}
+
+
+/* Remove a chamber (its cells stay in the members array until the next full computation) */
+static void killChamber(t_chambers* ch, int id) {
+	t_chamber* C = &ch->ch[id];
+	for (int i = 0; i < C->size; i++)
+		removeCellChamber(ch, ch->members[C->start + i], id);
+	C->size = -1;
+}
+
+
+/* Get a new stamp (two values: one for the allowed cells, the following for the visited cells) */
+static unsigned int newStamp(t_chambers* ch) {
+	if (ch->stamp > 0xFFFFFFF0u) {
+		memset(ch->mark, 0, ch->nbCells * sizeof(unsigned int));
+		ch->stamp = 0;
+	}
+	ch->stamp += 2;
+	return ch->stamp;
+}
+
+
+/* Decompose in chambers the subgraph of the cells marked with the current stamp
+ * (iterative Tarjan algorithm, rooted at the given cells, or all the cells if roots is NULL) */
+static void decompose(t_chambers* ch, const int* roots, int nbRoots) {
+	unsigned int allowed = ch->stamp, visited = ch->stamp + 1;
+	int time = 0;
+
+	for (int i = 0; i < nbRoots; i++) {
+		int r = roots ? roots[i] : i;
+		if (ch->mark[r] != allowed)
+			continue;
+
+		/* depth-first search from r */
+		ch->mark[r] = visited;
+		ch->disc[r] = ch->low[r] = ++time;
+		ch->parent[r] = -1;
+		ch->iter[r] = 0;
+		int top = 0, vtop = 0;
+		ch->dfs[top++] = r;
+		ch->vstack[vtop++] = r;
+		while (top) {
+			int v = ch->dfs[top - 1];
+			if (ch->iter[v] < 4) {
+				int w = ch->next[4 * v + ch->iter[v]++];
+				if (w < 0)
+					continue;
+				if (ch->mark[w] == allowed) {
+					ch->mark[w] = visited;
+					ch->disc[w] = ch->low[w] = ++time;
+					ch->parent[w] = v;
+					ch->iter[w] = 0;
+					ch->dfs[top++] = w;
+					ch->vstack[vtop++] = w;
+				}
+				else if (ch->mark[w] == visited && w != ch->parent[v])
+					ch->low[v] = MIN(ch->low[v], ch->disc[w]);
+			}
+			else {
+				top--;
+				int u = ch->parent[v];
+				if (u < 0)
+					continue;
+				ch->low[u] = MIN(ch->low[u], ch->low[v]);
+				if (ch->low[v] >= ch->disc[u]) {
+					/* u separates the cells above v in the stack: they form a chamber with u */
+					int k = vtop;
+					while (ch->vstack[--k] != v);
+					emitChamber(ch, ch->vstack + k, vtop - k, u);
+					vtop = k;
+				}
+			}
+		}
+
+		/* an isolated cell is a chamber by itself */
+		if (nbCellChambers(ch, r) == 0)
+			emitChamber(ch, &r, 1, -1);
+	}
+}
+
+
+/* Decompose again the chamber id, without the cell h (that is now occupied) */
+static void splitChamber(t_chambers* ch, int id, int h) {
+	t_chamber* C = &ch->ch[id];
+	unsigned int stamp = newStamp(ch);
+	int n = 0;
+	for (int i = 0; i < C->size; i++) {
+		int c = ch->members[C->start + i];
+		if (c != h) {
+			ch->work[n++] = c;
+			ch->mark[c] = stamp;
+		}
+	}
+	killChamber(ch, id);
+	decompose(ch, ch->work, n);
+}
+
+
+/* Add the (freed) cell u to the decomposition
+ * Returns 0 if it cannot be done locally (two chambers or more should be merged) */
+static int addCell(t_chambers* ch, int u) {
+	int neigh[4], k = 0;
+	for (int d = 0; d < 4; d++) {
+		int n = ch->next[4 * u + d];
+		if (n >= 0 && !ch->blocked[n])
+			neigh[k++] = n;
+	}
+
+	if (k == 0) {
+		emitChamber(ch, &u, 1, -1);
+		return 1;
+	}
+	if (k == 1) {
+		/* u hangs to its neighbour (an isolated neighbour is merged with it) */
+		int id = firstCellChamber(ch, neigh[0]);
+		if (nbCellChambers(ch, neigh[0]) == 1 && ch->ch[id].size == 1)
+			killChamber(ch, id);
+		emitChamber(ch, neigh, 1, u);
+		return 1;
+	}
+
+	/* u joins the chamber that contains all its neighbours (it is still biconnected) */
+	for (int i = 0; i < 4; i++) {
+		int id = ch->cellCh[4 * neigh[0] + i];
+		if (id < 0)
+			continue;
+		int common = 1;
+		for (int j = 1; j < k && common; j++)
+			common = inChamber(ch, neigh[j], id);
+		if (common) {
+			t_chamber* C = &ch->ch[id];
+			memcpy(ch->work, ch->members + C->start, C->size * sizeof(int));
+			int n = C->size;
+			killChamber(ch, id);
+			emitChamber(ch, ch->work, n, u);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+
+/* ---------------------------------------------------------
+ * Create and compute the chambers decomposition of a game
+ *
+ * Returns the decomposition (to be freed with `freeChambers`)
+ */
+t_chambers* newChambers(const t_game* game) {
+	int n = game->nbCells;
+	t_chambers* ch = calloc(1, sizeof(t_chambers));
+	if (!ch)
+		dispError(__FUNCTION__, "Cannot allocate the chambers");
+	ch->sizeX = game->sizeX;
+	ch->nbCells = n;
+	ch->next = game->next;
+	ch->capCh = 4 * n + 16;
+	ch->capMembers = 8 * n + 64;
+	ch->blocked = malloc(n);
+	ch->cellCh = malloc(4 * n * sizeof(int));
+	ch->ch = malloc(ch->capCh * sizeof(t_chamber));
+	ch->members = malloc(ch->capMembers * sizeof(int));
+	ch->disc = malloc(n * sizeof(int));
+	ch->low = malloc(n * sizeof(int));
+	ch->parent = malloc(n * sizeof(int));
+	ch->iter = malloc(n * sizeof(int));
+	ch->dfs = malloc(n * sizeof(int));
+	ch->vstack = malloc(n * sizeof(int));
+	ch->work = malloc(n * sizeof(int));
+	ch->mark = calloc(n, sizeof(unsigned int));
+	if (!ch->blocked || !ch->cellCh || !ch->ch || !ch->members || !ch->disc || !ch->low || !ch->parent
+		|| !ch->iter || !ch->dfs || !ch->vstack || !ch->work || !ch->mark)
+		dispError(__FUNCTION__, "Cannot allocate the chambers");
+
+	computeChambers(ch, game);
+	return ch;
+}
+
+
+/* ------------------------------
+ * Free a chambers decomposition
+ */
+void freeChambers(t_chambers* ch) {
+	if (!ch)
+		return;
+	free(ch->blocked);
+	free(ch->cellCh);
+	free(ch->ch);
+	free(ch->members);
+	free(ch->disc);
+	free(ch->low);
+	free(ch->parent);
+	free(ch->iter);
+	free(ch->dfs);
+	free(ch->vstack);
+	free(ch->work);
+	free(ch->mark);
+	free(ch);
+}
+
+
+/* ------------------------------------------------------
+ * Compute (from scratch) the chambers decomposition of the game
+ * (the game may be another one, or have another arena, but with the same number of cells)
+ */
+void computeChambers(t_chambers* ch, const t_game* game) {
+	if (game->nbCells != ch->nbCells)
+		dispError(__FUNCTION__, "The game has %d cells instead of %d", game->nbCells, ch->nbCells);
+	ch->sizeX = game->sizeX;
+	ch->next = game->next;
+	ch->arenaId = game->arenaId;
+	ch->nbCh = 0;
+	ch->nbMembers = 0;
+	ch->overflow = 0;
+	memset(ch->cellCh, -1, 4 * ch->nbCells * sizeof(int));
+
+	/* snapshot of the game */
+	unsigned int stamp = newStamp(ch);
+	for (int c = 0; c < ch->nbCells; c++) {
+		ch->blocked[c] = game->occupied[c] != 0;
+		if (!ch->blocked[c])
+			ch->mark[c] = stamp;
+	}
+	for (int p = 0; p < 2; p++) {
+		ch->head[p] = snakeHead(game, p);
+		ch->tail[p] = snakeTail(game, p);
+	}
+	ch->turn = game->turn;
+
+	decompose(ch, NULL, ch->nbCells);
+	ch->nbFull++;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Update the chambers decomposition when only the heads and tails have changed
+ * since the last update (each snake has played, or undone, at most one move,
+ * or a sibling move has been played instead of the previous one)
+ * The chambers that contain no changed cell are kept as they are.
+ * It falls back to `computeChambers` when the changes cannot be handled locally,
+ * when the arena is not the one of the last update (another `next` array, or another arenaId),
+ * or when the turn differs by more than two moves
+ * The other cells are supposed not to have changed (compile with -DCHAMBER_CHECK to verify it,
+ * in O(nbCells), and to recompute the chambers if it is not the case)
+ */
+void updateChambers(t_chambers* ch, const t_game* game) {
+	int cand[8], nbCand = 0;
+
+	/* another arena (or another copy of it), or a position too far from the snapshot */
+	if (game->next != ch->next || game->arenaId != ch->arenaId || abs(game->turn - ch->turn) > 2) {
+		computeChambers(ch, game);
+		return;
+	}
+	for (int p = 0; p < 2; p++) {
+		cand[nbCand++] = ch->head[p];
+		cand[nbCand++] = ch->tail[p];
+		cand[nbCand++] = snakeHead(game, p);
+		cand[nbCand++] = snakeTail(game, p);
+	}
+
+#ifdef CHAMBER_CHECK
+	/* the occupied cells must only differ from the snapshot by these cells
+	 * (otherwise the position is not adjacent to the snapshot) */
+	unsigned int stamp = newStamp(ch);
+	for (int i = 0; i < nbCand; i++)
+		ch->mark[cand[i]] = stamp;
+	for (int c = 0; c < ch->nbCells; c++)
+		if ((game->occupied[c] != 0) != ch->blocked[c] && ch->mark[c] != stamp) {
+			dispDebug(__FUNCTION__, 1, "The position is not adjacent to the snapshot");
+			computeChambers(ch, game);
+			return;
+		}
+#endif
+
+	/* the cells that have been occupied first (their chambers are split) */
+	for (int i = 0; i < nbCand; i++) {
+		int c = cand[i];
+		if (game->occupied[c] && !ch->blocked[c]) {
+			ch->blocked[c] = 1;
+			int id;
+			while ((id = firstCellChamber(ch, c)) >= 0)
+				splitChamber(ch, id, c);
+		}
+	}
+
+	/* then the freed cells */
+	for (int i = 0; i < nbCand; i++) {
+		int c = cand[i];
+		if (!game->occupied[c] && ch->blocked[c]) {
+			ch->blocked[c] = 0;
+			if (!addCell(ch, c)) {
+				computeChambers(ch, game);
+				return;
+			}
+		}
+	}
+
+	if (ch->overflow) {
+		computeChambers(ch, game);
+		return;
+	}
+
+	for (int p = 0; p < 2; p++) {
+		ch->head[p] = snakeHead(game, p);
+		ch->tail[p] = snakeTail(game, p);
+	}
+	ch->turn = game->turn;
+	ch->nbIncremental++;
+}
+
+
+/* Number of cells of the chamber id that can be filled, entering it by the cell e (-1 when we start in it)
+ * In a grid, a path alternates black and white cells, so it cannot use more than 2*min(black,white)+1 cells */
+static int fillChamber(const t_chambers* ch, int id, int e) {
+	const t_chamber* C = &ch->ch[id];
+	int cells = C->size, black = C->black;
+	if (e >= 0) {
+		cells--;
+		black -= ((e % ch->sizeX) + (e / ch->sizeX)) % 2 == 0;
+	}
+	int m = MIN(black, cells - black);
+	return MIN(cells, 2 * m + 1);
+}
+
+
+/* Longest fillable path in the chamber id (entered by e), going then to the best child chamber */
+static int valueChamber(const t_chambers* ch, int id, int e) {
+	const t_chamber* C = &ch->ch[id];
+	int best = 0;
+	for (int i = 0; i < C->size; i++) {
+		int b = ch->members[C->start + i];
+		if (b == e || nbCellChambers(ch, b) < 2)
+			continue;
+		/* b is an articulation point, leading to other chambers */
+		for (int j = 0; j < 4; j++) {
+			int D = ch->cellCh[4 * b + j];
+			if (D >= 0 && D != id)
+				best = MAX(best, valueChamber(ch, D, b));
+		}
+	}
+	return fillChamber(ch, id, e) + best;
+}
+
+
+/* ----------------------------------------------------------------------------
+ * Estimate the length of the longest path the snake p can fill from its head,
+ * through the tree of the chambers (the decomposition must be up to date)
+ */
+int chamberFill(t_chambers* ch, const t_game* game, int p) {
+	int head = snakeHead(game, p);
+	int best = 0;
+	for (int d = 0; d < 4; d++) {
+		int n = ch->next[4 * head + d];
+		if (n < 0 || ch->blocked[n])
+			continue;
+		int v = 1;
+		if (nbCellChambers(ch, n) >= 2) {
+			/* we start on an articulation point: choose the best chamber */
+			int sub = 0;
+			for (int j = 0; j < 4; j++)
+				if (ch->cellCh[4 * n + j] >= 0)
+					sub = MAX(sub, valueChamber(ch, ch->cellCh[4 * n + j], n));
+			v += sub;
+		}
+		else if (nbCellChambers(ch, n) == 1)
+			v = valueChamber(ch, firstCellChamber(ch, n), -1);
+		best = MAX(best, v);
+	}
+	return best;
+}
+
+
+/* --------------------------------------------------------
+ * Evaluate the position for the player p: difference between
+ * the fillable lengths of the snake p and of its opponent
+ */
+int evalChambers(t_chambers* ch, const t_game* game, int p) {
+	return chamberFill(ch, game, p) - chamberFill(ch, game, 1 - p);
+}
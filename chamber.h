@@ -0,0 +1,112 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: chamber.h
+	Chamber (biconnected components) decomposition of the free cells,
+	used to estimate the longest path a snake can fill
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_CHAMBER__
+#define __SNAKE_CHAMBER__
+#include "snakeGame.h"
+
+
+/* A chamber is a biconnected component of the graph of the free cells
+ * (two chambers share at most one cell, an articulation point) */
+typedef struct {
+	int start;		/* index of the first cell of the chamber in the members array */
+	int size;		/* number of cells of the chamber (-1 if the chamber has been removed) */
+	int black;		/* number of cells (x,y) of the chamber with x+y even */
+} t_chamber;
+
+
+/* The decomposition of the arena in chambers
+ * (it keeps a snapshot of the game it has been computed for, to allow incremental updates) */
+typedef struct {
+	int sizeX, nbCells;
+	const int* next;		/* neighbours of the cells (shared with the game) */
+	unsigned int arenaId;	/* arena of the snapshot (see `t_game`) */
+	unsigned char* blocked;	/* snapshot of the occupied cells */
+	int head[2], tail[2];	/* snapshot of the heads and tails */
+	int turn;				/* snapshot of the turn */
+	int* cellCh;			/* cellCh[4*c+i]: chambers containing the cell c (-1 for none) */
+	t_chamber* ch;			/* chambers */
+	int nbCh, capCh;
+	int* members;			/* cells of the chambers */
+	int nbMembers, capMembers;
+	int *disc, *low, *parent, *iter, *dfs, *vstack, *work;	/* work arrays for the decomposition */
+	unsigned int* mark;
+	unsigned int stamp;
+	int overflow;			/* set when the chambers or members arrays are full */
+	int nbFull, nbIncremental;	/* statistics: number of full and incremental updates */
+} t_chambers;
+
+
+
+/* ---------------------------------------------------------
+ * Create and compute the chambers decomposition of a game
+ *
+ * Returns the decomposition (to be freed with `freeChambers`)
+ */
+t_chambers* newChambers(const t_game* game);
+
+
+/* ------------------------------
+ * Free a chambers decomposition
+ */
+void freeChambers(t_chambers* ch);
+
+
+/* ------------------------------------------------------
+ * Compute (from scratch) the chambers decomposition of the game
+ * (the game may be another one, or have another arena, but with the same number of cells)
+ */
+void computeChambers(t_chambers* ch, const t_game* game);
+
+
+/* ------------------------------------------------------------------------
+ * Update the chambers decomposition when only the heads and tails have changed
+ * since the last update (each snake has played, or undone, at most one move,
+ * or a sibling move has been played instead of the previous one)
+ * The chambers that contain no changed cell are kept as they are.
+ * It falls back to `computeChambers` when the changes cannot be handled locally,
+ * when the arena is not the one of the last update (another `next` array, or another arenaId),
+ * or when the turn differs by more than two moves
+ * The other cells are supposed not to have changed (compile with -DCHAMBER_CHECK to verify it,
+ * in O(nbCells), and to recompute the chambers if it is not the case)
+ */
+void updateChambers(t_chambers* ch, const t_game* game);
+
+
+/* ----------------------------------------------------------------------------
+ * Estimate the length of the longest path the snake p can fill from its head,
+ * through the tree of the chambers (the decomposition must be up to date)
+ */
+int chamberFill(t_chambers* ch, const t_game* game, int p);
+
+
+/* --------------------------------------------------------
+ * Evaluate the position for the player p: difference between
+ * the fillable lengths of the snake p and of its opponent
+ */
+int evalChambers(t_chambers* ch, const t_game* game, int p);
+
+
+#endif
@@ -37,16 +37,24 @@ Copyright 2016-2020 T. Hilaire, J. Brajard
 #define HEAD_SIZE 6 			/*number of bytes to code the size of the message (header)*/
 #define MAX_LENGTH 20000 		/* maximum size of the buffer expected for print_Game */
 
+/* when compiled with -DCGS_THREADED, the connection is local to each thread
+ * (so that a program can open several connections, one per thread) */
+#ifdef CGS_THREADED
+#define CGS_LOCAL __thread
+#else
+#define CGS_LOCAL
+#endif
+
 
 
 /* global variables about the connection
  * we use them just to hide all the connection details to the user
  * so no need to know about them, or give them when we use the functions of this API
 */
-int sockfd = -1;		        /* socket descriptor, equal to -1 when we are not yet connected */
-char buffer[MAX_LENGTH];		/* global buffer used to send message (global so that it is not allocated/desallocated for each message) */
+CGS_LOCAL int sockfd = -1;		        /* socket descriptor, equal to -1 when we are not yet connected */
+CGS_LOCAL char buffer[MAX_LENGTH];		/* global buffer used to send message (global so that it is not allocated/desallocated for each message) */
 int debug=0;			        /* debug constant; we do not use here a #DEFINE, since it allows the client to declare 'extern int debug;' set it to 1 to have debug information, without having to re-compile labyrinthAPI.c */
-char playerName[21] = {};       /* name of the player, stored to display it in debug */
+CGS_LOCAL char playerName[21] = {};       /* name of the player, stored to display it in debug */
 
 
 /* Display Error message and exit
@@ -98,9 +106,9 @@ void dispDebug(const char* fct, int level, const char* msg, ...) {
 * Return the remaining length of the message (0 is the message is completely read)
 */
 size_t read_inbuf(const char *fct, char *buf, size_t nbuf) {
-	static char stream_size[HEAD_SIZE];		/* size of the message to be received, static to avoid allocate memory at each call*/
+	static CGS_LOCAL char stream_size[HEAD_SIZE];		/* size of the message to be received, static to avoid allocate memory at each call*/
 	ssize_t r;
-	static size_t length=0 ; 				/* static because some length has to be read again */
+	static CGS_LOCAL size_t length=0 ; 				/* static because some length has to be read again */
 	if (!length) {
 		bzero(stream_size, HEAD_SIZE);
 		r = read(sockfd, stream_size, HEAD_SIZE);
@@ -0,0 +1,372 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: distOracle.c
+	Distances between the cells of the arena (walls only, the snakes are ignored),
+	precomputed once per game, and compression of the arena in a graph of
+	rooms, junctions and corridors
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "clientAPI.h"
+#include "distOracle.h"
+
+
+/* BFS from the cell s (walls only), fills dist (ORACLE_INF for the unreached cells)
+ * Returns the largest finite distance */
+static int bfs(const int* next, int nbCells, int s, uint16_t* dist, int* queue) {
+	for (int c = 0; c < nbCells; c++)
+		dist[c] = ORACLE_INF;
+	int first = 0, last = 0, ecc = 0;
+	dist[s] = 0;
+	queue[last++] = s;
+	while (first < last) {
+		int c = queue[first++];
+		ecc = dist[c];
+		for (int d = 0; d < 4; d++) {
+			int n = next[4 * c + d];
+			if (n >= 0 && dist[n] == ORACLE_INF) {
+				dist[n] = dist[c] + 1;
+				queue[last++] = n;
+			}
+		}
+	}
+	return ecc;
+}
+
+
+/* thread: BFS from the sources given by the shared counter (all pairs) */
+static void* fullWorker(void* arg) {
+	t_oracle* o = arg;
+	int n = o->nbCells;
+	uint16_t* dist = malloc(n * sizeof(uint16_t));
+	int* queue = malloc(n * sizeof(int));
+	if (!dist || !queue)
+		dispError(__FUNCTION__, "Cannot allocate the work arrays");
+	int s;
+	while ((s = __atomic_fetch_add(&o->nextSource, 1, __ATOMIC_RELAXED)) < n) {
+		bfs(o->next, n, s, o->wide ? o->d16 + (size_t) s * n : dist, queue);
+		if (!o->wide)
+			for (int c = 0; c < n; c++)
+				o->d8[(size_t) s * n + c] = dist[c] == ORACLE_INF ? 255 : dist[c];
+		__atomic_fetch_add(&o->nbDone, 1, __ATOMIC_RELEASE);
+	}
+	free(dist);
+	free(queue);
+	return NULL;
+}
+
+
+/* thread: choice of the landmarks (each one is the farthest cell from the previous ones) and their BFS */
+static void* landmarkWorker(void* arg) {
+	t_oracle* o = arg;
+	int n = o->nbCells;
+	uint16_t* minDist = malloc(n * sizeof(uint16_t));
+	int* queue = malloc(n * sizeof(int));
+	if (!minDist || !queue)
+		dispError(__FUNCTION__, "Cannot allocate the work arrays");
+	/* the first landmark is the farthest cell from the cell 0 */
+	bfs(o->next, n, 0, minDist, queue);
+	for (int l = 0; l < o->nbLandmarks; l++) {
+		int best = 0;
+		for (int c = 1; c < n; c++)
+			if (minDist[c] > minDist[best])
+				best = c;
+		o->landmarks[l] = best;
+		uint16_t* row = o->d16 + (size_t) l * n;
+		bfs(o->next, n, best, row, queue);
+		for (int c = 0; c < n; c++)
+			if (row[c] < minDist[c] || l == 0)
+				minDist[c] = row[c];
+		__atomic_fetch_add(&o->nbDone, 1, __ATOMIC_RELEASE);
+	}
+	free(minDist);
+	free(queue);
+	return NULL;
+}
+
+
+/* indicate if the cell c is in a 2x2 block of cells without wall between them */
+static int openCell(const int* next, int c) {
+	/* the four blocks that contain c, given by two orthogonal directions from c */
+	for (int d = 0; d < 4; d++) {
+		int a = next[4 * c + d], b = next[4 * c + (d + 1) % 4];
+		if (a >= 0 && b >= 0 && next[4 * a + (d + 1) % 4] >= 0 && next[4 * a + (d + 1) % 4] == next[4 * b + d])
+			return 1;
+	}
+	return 0;
+}
+
+
+/* build the graph of rooms, junctions and corridors */
+static void buildGraph(t_corridorGraph* g, const int* next, int n) {
+	g->nodeCell = malloc(n * sizeof(int));
+	g->nodeSize = malloc(n * sizeof(int));
+	g->cellNode = malloc(n * sizeof(int));
+	g->corridors = malloc((2 * n + 1) * sizeof(t_corridor));
+	g->cells = malloc(n * sizeof(int));
+	g->cellCorridor = malloc(n * sizeof(int));
+	g->cellPos = calloc(n, sizeof(int));
+	g->adjStart = calloc(n + 1, sizeof(int));
+	g->adj = malloc((4 * n + 1) * sizeof(int));
+	char* open = malloc(n);
+	if (!g->nodeCell || !g->nodeSize || !g->cellNode || !g->corridors || !g->cells || !g->cellCorridor || !g->cellPos || !g->adjStart || !g->adj || !open)
+		dispError(__FUNCTION__, "Cannot allocate the graph");
+
+	for (int c = 0; c < n; c++) {
+		open[c] = openCell(next, c);
+		g->cellCorridor[c] = -1;
+		g->cellNode[c] = -1;
+	}
+
+	/* rooms: connected open cells (the queue is the array cells, not used yet) */
+	g->nbNodes = g->nbRooms = g->nbCorridors = 0;
+	for (int c = 0; c < n; c++)
+		if (open[c] && g->cellNode[c] < 0) {
+			int first = 0, last = 0;
+			g->cellNode[c] = g->nbNodes;
+			g->cells[last++] = c;
+			while (first < last) {
+				int cc = g->cells[first++];
+				for (int d = 0; d < 4; d++) {
+					int nc = next[4 * cc + d];
+					if (nc >= 0 && open[nc] && g->cellNode[nc] < 0) {
+						g->cellNode[nc] = g->nbNodes;
+						g->cells[last++] = nc;
+					}
+				}
+			}
+			g->nodeCell[g->nbNodes] = c;
+			g->nodeSize[g->nbNodes++] = last;
+			g->nbRooms++;
+		}
+
+	/* junctions: the other cells that have not exactly two neighbours */
+	for (int c = 0; c < n; c++) {
+		int deg = 0;
+		for (int d = 0; d < 4; d++)
+			deg += next[4 * c + d] >= 0;
+		if (!open[c] && deg != 2) {
+			g->cellNode[c] = g->nbNodes;
+			g->nodeCell[g->nbNodes] = c;
+			g->nodeSize[g->nbNodes++] = 1;
+		}
+	}
+	free(open);
+
+	/* corridors, from each cell of the nodes in each direction (each corridor is found from its two ends);
+	 * then the loops without node (one of their cells becomes a junction) */
+	int nbCells = 0;
+	for (int pass = 0; pass < 2; pass++)
+		for (int j = 0; j < n; j++) {
+			if (pass == 0 && g->cellNode[j] < 0)
+				continue;
+			if (pass) {
+				if (g->cellNode[j] >= 0 || g->cellCorridor[j] >= 0)
+					continue;
+				g->cellNode[j] = g->nbNodes;
+				g->nodeCell[g->nbNodes] = j;
+				g->nodeSize[g->nbNodes++] = 1;
+			}
+			for (int d = 0; d < 4; d++) {
+				int cur = next[4 * j + d], prev = j;
+				if (cur < 0 || g->cellCorridor[cur] >= 0 || g->cellNode[cur] == g->cellNode[j])
+					continue;		/* wall, corridor already found, or inside a room */
+				if (g->cellNode[cur] >= 0 && cur < j)
+					continue;		/* two adjacent nodes: the corridor is created from the smaller cell */
+				t_corridor* k = &g->corridors[g->nbCorridors];
+				k->a = g->cellNode[j];
+				k->cellA = j;
+				k->first = nbCells;
+				k->length = 1;
+				while (g->cellNode[cur] < 0) {
+					g->cells[nbCells++] = cur;
+					g->cellCorridor[cur] = g->nbCorridors;
+					g->cellPos[cur] = k->length++;
+					int e = 0;
+					while (next[4 * cur + e] < 0 || next[4 * cur + e] == prev)
+						e++;
+					prev = cur;
+					cur = next[4 * cur + e];
+				}
+				k->b = g->cellNode[cur];
+				k->cellB = cur;
+				g->nbCorridors++;
+			}
+		}
+
+	/* adjacency (CSR) */
+	for (int i = 0; i < g->nbCorridors; i++) {
+		g->adjStart[g->corridors[i].a + 1]++;
+		g->adjStart[g->corridors[i].b + 1]++;
+	}
+	for (int i = 0; i < g->nbNodes; i++)
+		g->adjStart[i + 1] += g->adjStart[i];
+	int* pos = malloc((g->nbNodes + 1) * sizeof(int));
+	if (!pos)
+		dispError(__FUNCTION__, "Cannot allocate the graph");
+	memcpy(pos, g->adjStart, (g->nbNodes + 1) * sizeof(int));
+	for (int i = 0; i < g->nbCorridors; i++) {
+		g->adj[pos[g->corridors[i].a]++] = i;
+		g->adj[pos[g->corridors[i].b]++] = i;
+	}
+	free(pos);
+}
+
+
+/* -----------------------------------------------------------------------
+ * Start the construction of the oracle of a game (walls only), in nbThreads threads
+ * (0 for the number of cores); it can then be used after `oracleWait`, or when `oracleReady` is 1
+ *
+ * Returns the oracle (to be freed with `freeOracle`)
+ */
+t_oracle* oracleBuild(const t_game* game, int nbThreads) {
+	int n = game->nbCells;
+	t_oracle* o = calloc(1, sizeof(t_oracle));
+	if (!o)
+		dispError(__FUNCTION__, "Cannot allocate the oracle");
+	o->nbCells = n;
+	o->next = malloc(4 * n * sizeof(int));
+	if (!o->next)
+		dispError(__FUNCTION__, "Cannot allocate the oracle");
+	memcpy(o->next, game->next, 4 * n * sizeof(int));
+	buildGraph(&o->graph, o->next, n);
+
+	o->full = n <= ORACLE_MAX_FULL;
+	if (o->full) {
+		/* 8 bits are enough if the diameter of each component (at most twice the eccentricity of one of its cells) is below 255 */
+		uint16_t* dist = malloc(n * sizeof(uint16_t));
+		int* queue = malloc(n * sizeof(int));
+		char* seen = calloc(n, 1);
+		if (!dist || !queue || !seen)
+			dispError(__FUNCTION__, "Cannot allocate the oracle");
+		int diameter = 0;
+		for (int c = 0; c < n && diameter < 255; c++)
+			if (!seen[c]) {
+				int ecc = bfs(o->next, n, c, dist, queue);
+				if (2 * ecc > diameter)
+					diameter = 2 * ecc;
+				for (int cc = 0; cc < n; cc++)
+					seen[cc] |= dist[cc] != ORACLE_INF;
+			}
+		free(dist);
+		free(queue);
+		free(seen);
+		o->wide = diameter >= 255;
+		if (o->wide)
+			o->d16 = malloc((size_t) n * n * sizeof(uint16_t));
+		else
+			o->d8 = malloc((size_t) n * n);
+		if (!o->d8 && !o->d16)
+			dispError(__FUNCTION__, "Cannot allocate the distances (%d cells)", n);
+		o->nbSources = n;
+		if (nbThreads <= 0)
+			nbThreads = sysconf(_SC_NPROCESSORS_ONLN);
+		if (nbThreads > n)
+			nbThreads = n;
+	}
+	else {
+		o->wide = 1;
+		o->nbLandmarks = ORACLE_LANDMARKS;
+		o->landmarks = malloc(ORACLE_LANDMARKS * sizeof(int));
+		o->d16 = malloc((size_t) ORACLE_LANDMARKS * n * sizeof(uint16_t));
+		if (!o->landmarks || !o->d16)
+			dispError(__FUNCTION__, "Cannot allocate the landmarks");
+		o->nbSources = ORACLE_LANDMARKS;
+		nbThreads = 1;		/* each landmark depends on the previous ones */
+	}
+
+	o->nbThreads = nbThreads;
+	o->threads = malloc(nbThreads * sizeof(pthread_t));
+	if (!o->threads)
+		dispError(__FUNCTION__, "Cannot allocate the threads");
+	for (int i = 0; i < nbThreads; i++)
+		if (pthread_create(&o->threads[i], NULL, o->full ? fullWorker : landmarkWorker, o))
+			dispError(__FUNCTION__, "Cannot create a thread");
+	dispDebug(__FUNCTION__, 2, "%d cells, %d rooms, %d junctions, %d corridors, %s", n, o->graph.nbRooms,
+		o->graph.nbNodes - o->graph.nbRooms, o->graph.nbCorridors,
+		o->full ? (o->wide ? "all pairs (16 bits)" : "all pairs (8 bits)") : "landmarks");
+	return o;
+}
+
+
+/* --------------------------------------------------------
+ * Indicate if the construction is over (1), without waiting
+ */
+int oracleReady(t_oracle* o) {
+	return __atomic_load_n(&o->nbDone, __ATOMIC_ACQUIRE) == o->nbSources;
+}
+
+
+/* --------------------------------------------------------
+ * Wait for the end of the construction
+ */
+void oracleWait(t_oracle* o) {
+	if (!o->threads)
+		return;
+	for (int i = 0; i < o->nbThreads; i++)
+		pthread_join(o->threads[i], NULL);
+	free(o->threads);
+	o->threads = NULL;
+}
+
+
+/* ------------------
+ * Free an oracle
+ */
+void freeOracle(t_oracle* o) {
+	if (!o)
+		return;
+	oracleWait(o);
+	t_corridorGraph* g = &o->graph;
+	free(g->nodeCell);
+	free(g->nodeSize);
+	free(g->cellNode);
+	free(g->corridors);
+	free(g->cells);
+	free(g->cellCorridor);
+	free(g->cellPos);
+	free(g->adjStart);
+	free(g->adj);
+	free(o->d8);
+	free(o->d16);
+	free(o->landmarks);
+	free(o->next);
+	free(o);
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Lower and upper bounds of the distance between two cells (equal if oracle->full)
+ */
+void oracleBounds(const t_oracle* o, int a, int b, int* lo, int* hi) {
+	*lo = oracleDist(o, a, b);
+	if (o->full || *lo == ORACLE_INF) {
+		*hi = *lo;
+		return;
+	}
+	*hi = ORACLE_INF;
+	for (int l = 0; l < o->nbLandmarks; l++) {
+		int da = o->d16[l * o->nbCells + a], db = o->d16[l * o->nbCells + b];
+		if (da != ORACLE_INF && db != ORACLE_INF && da + db < *hi)
+			*hi = da + db;
+	}
+}
@@ -0,0 +1,148 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: distOracle.h
+	Distances between the cells of the arena (walls only, the snakes are ignored),
+	precomputed once per game, and compression of the arena in a graph of
+	rooms, junctions and corridors
+
+	The walls do not change during a game, so the distances can be computed
+	(by several threads, during the first turn) and then read in O(1)
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_DIST_ORACLE__
+#define __SNAKE_DIST_ORACLE__
+#include <stdint.h>
+#include <pthread.h>
+#include "snakeGame.h"
+
+
+#define ORACLE_MAX_FULL 4096	/* all the pairs are stored up to this number of cells, landmarks are used above */
+#define ORACLE_LANDMARKS 16		/* number of landmarks for the large arenas */
+#define ORACLE_INF 0xFFFF		/* distance between two cells that cannot reach each other */
+
+
+/* A corridor: path of cells with exactly two neighbours, between two nodes */
+typedef struct {
+	int a, b;				/* nodes at the ends (a==b for a loop) */
+	int cellA, cellB;		/* cells of a and b where the corridor starts and ends */
+	int length;				/* number of moves from cellA to cellB */
+	int first;				/* the inner cells are cells[first] ... cells[first+length-2], from a to b */
+} t_corridor;
+
+
+/* The arena as a graph, whose edges are the corridors and whose nodes are
+ * - the rooms: open areas, i.e. connected cells that are in a 2x2 block without wall
+ *   (an arena without wall is a single room); crossing a room costs the distance between its two cells
+ * - the junctions: the other cells with 0, 1, 3 or 4 neighbours
+ * The rooms are the nodes 0 ... nbRooms-1 */
+typedef struct {
+	int nbNodes, nbRooms, nbCorridors;
+	int* nodeCell;			/* a cell of each node (the only one for a junction) */
+	int* nodeSize;			/* number of cells of each node (1 for a junction) */
+	int* cellNode;			/* node of each cell (-1 for a cell inside a corridor) */
+	t_corridor* corridors;
+	int* cells;				/* inner cells of the corridors */
+	int* cellCorridor;		/* corridor of each cell (-1 for a junction) */
+	int* cellPos;			/* position of a cell in its corridor (1 for the cell next to a) */
+	int* adjStart;			/* corridors of the node n: adj[adjStart[n]] ... adj[adjStart[n+1]-1] */
+	int* adj;
+} t_corridorGraph;
+
+
+/* The oracle */
+typedef struct {
+	int nbCells;
+	int full;				/* 1 if all the pairs are stored, 0 for landmarks */
+	int wide;				/* 1 if the distances are stored on 16 bits, 0 for 8 bits */
+	uint8_t* d8;			/* d8[a*nbCells+b] (255 for ORACLE_INF) */
+	uint16_t* d16;			/* d16[a*nbCells+b] or, for the landmarks, d16[l*nbCells+b] */
+	int nbLandmarks;
+	int* landmarks;
+	t_corridorGraph graph;
+	/* parallel construction */
+	int* next;				/* copy of the neighbours of the game */
+	int nbThreads;
+	pthread_t* threads;
+	int nextSource;			/* next source to process (atomic) */
+	int nbDone;				/* number of sources done (atomic) */
+	int nbSources;
+} t_oracle;
+
+
+
+/* -----------------------------------------------------------------------
+ * Start the construction of the oracle of a game (walls only), in nbThreads threads
+ * (0 for the number of cores); it can then be used after `oracleWait`, or when `oracleReady` is 1
+ *
+ * Returns the oracle (to be freed with `freeOracle`)
+ */
+t_oracle* oracleBuild(const t_game* game, int nbThreads);
+
+
+/* --------------------------------------------------------
+ * Indicate if the construction is over (1), without waiting
+ */
+int oracleReady(t_oracle* oracle);
+
+
+/* --------------------------------------------------------
+ * Wait for the end of the construction
+ */
+void oracleWait(t_oracle* oracle);
+
+
+/* ------------------
+ * Free an oracle
+ */
+void freeOracle(t_oracle* oracle);
+
+
+/* ---------------------------------------------------------------------------
+ * Distance between two cells (ORACLE_INF if they cannot reach each other)
+ * Exact if oracle->full, otherwise a lower bound (given by the landmarks)
+ */
+static inline int oracleDist(const t_oracle* o, int a, int b) {
+	if (o->full) {
+		if (o->wide)
+			return o->d16[a * o->nbCells + b];
+		int d = o->d8[a * o->nbCells + b];
+		return d == 255 ? ORACLE_INF : d;
+	}
+	int lo = 0;
+	for (int l = 0; l < o->nbLandmarks; l++) {
+		int da = o->d16[l * o->nbCells + a], db = o->d16[l * o->nbCells + b];
+		if ((da == ORACLE_INF) != (db == ORACLE_INF))
+			return ORACLE_INF;
+		int d = da > db ? da - db : db - da;
+		if (da != ORACLE_INF && d > lo)
+			lo = d;
+	}
+	return lo;
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Lower and upper bounds of the distance between two cells (equal if oracle->full)
+ */
+void oracleBounds(const t_oracle* o, int a, int b, int* lo, int* hi);
+
+
+#endif
@@ -0,0 +1,377 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: endgame.c
+	Endgame solver, when the two snakes are in separated regions
+	(the snake that survives longer in its own region wins)
+
+	Each cell of the region has a release time: the move from which the snake can enter it
+	(0 for a free cell). When the snake enters a cell at move j, the cell is released
+	when the snake has done, after j, as many non-growing moves as its length.
+	A state at move j is then given by the head and the cells not yet released (with their
+	release times), and is memoized with a hash of them (the cells already released do not
+	count, whatever the path that has freed them). The release times are all different, so
+	the cell released at a given move is known, and the hash is updated at each move.
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "clientAPI.h"
+#include "endgame.h"
+#include "searchStats.h"
+
+
+#define MEMO_BITS 18			/* size of the memoization table (2^MEMO_BITS entries) */
+#define INFINITE_TIME 0x3FFFFFFF	/* release time of a cell never released within the horizon */
+
+
+/* data of the search (local indexes are used for the cells of the region) */
+typedef struct {
+	int n;					/* number of cells of the region */
+	int* next;				/* next[4*i+d]: local neighbour of the cell i in direction d, or -1 */
+	int* release;			/* release[i]: move from which the cell i can be entered */
+	int* freeAt;			/* freeAt[j]: release time of a cell entered at move j */
+	int* cellAt;			/* cellAt[t]: cell whose release time is t (if any) */
+	int horizon;			/* maximal number of moves (then the snake does not fit in the region) */
+	t_memo* memo;
+	unsigned int generation;
+	unsigned long long hash;	/* hash of the cells not yet released (with their release times) */
+	long nbNodes;
+	int timeout;			/* 1 when the time budget is exceeded */
+	struct timespec deadline;
+} t_search;
+
+
+
+/* mix two integers in a 64-bit hash (splitmix64 finalizer) */
+static unsigned long long mix(unsigned long long x) {
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+static unsigned long long cellKey(int cell, int release) {
+	return mix(((unsigned long long) cell << 32) | (unsigned int) release);
+}
+
+
+/* deadline in `budget` seconds */
+static void setDeadline(struct timespec* t, double budget) {
+	clock_gettime(CLOCK_MONOTONIC, t);
+	long ns = t->tv_nsec + (long) ((budget - (long) budget) * 1e9);
+	t->tv_sec += (long) budget + ns / 1000000000L;
+	t->tv_nsec = ns % 1000000000L;
+}
+
+static int deadlinePassed(const struct timespec* t) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec > t->tv_sec || (now.tv_sec == t->tv_sec && now.tv_nsec >= t->tv_nsec);
+}
+
+
+/* BFS from the head of the snake p, through the free cells and its own body
+ * fill region (with -1 for the other cells, or the local index) and returns the number of cells */
+static int snakeRegion(const t_game* game, int p, int* region, int* queue) {
+	int n = 0;
+	memset(region, -1, game->nbCells * sizeof(int));
+	int head = snakeHead(game, p);
+	region[head] = n;
+	queue[n++] = head;
+	for (int i = 0; i < n; i++)
+		for (int d = 0; d < 4; d++) {
+			int c = game->next[4 * queue[i] + d];
+			if (c >= 0 && region[c] < 0 && (!game->occupied[c] || game->occupied[c] == p + 1)) {
+				region[c] = n;
+				queue[n++] = c;
+			}
+		}
+	return n;
+}
+
+
+/* ------------------------------------------------------------
+ * Create the working memory of the solver for a game (only its size is used)
+ *
+ * Returns the working memory (to be freed with `freeEndgame`)
+ */
+t_endgame* newEndgame(const t_game* game) {
+	int n = game->nbCells, nbTimes = GROWTH_PERIOD * n + 4;
+	t_endgame* eg = calloc(1, sizeof(t_endgame));
+	if (!eg)
+		dispError(__FUNCTION__, "Cannot allocate the endgame solver");
+	eg->nbCells = n;
+	eg->region = malloc(n * sizeof(int));
+	eg->region2 = malloc(n * sizeof(int));
+	eg->queue = malloc(n * sizeof(int));
+	eg->next = malloc(4 * n * sizeof(int));
+	eg->release = malloc(n * sizeof(int));
+	eg->nonGrowing = malloc(nbTimes * sizeof(int));
+	eg->freeAt = malloc(nbTimes * sizeof(int));
+	eg->cellAt = malloc(nbTimes * sizeof(int));
+	if (!eg->region || !eg->region2 || !eg->queue || !eg->next || !eg->release
+		|| !eg->nonGrowing || !eg->freeAt || !eg->cellAt)
+		dispError(__FUNCTION__, "Cannot allocate the endgame solver");
+	return eg;
+}
+
+
+/* ----------------------------------
+ * Free the working memory of the solver
+ */
+void freeEndgame(t_endgame* eg) {
+	if (!eg)
+		return;
+	free(eg->region);
+	free(eg->region2);
+	free(eg->queue);
+	free(eg->next);
+	free(eg->release);
+	free(eg->nonGrowing);
+	free(eg->freeAt);
+	free(eg->cellAt);
+	free(eg->memo);
+	free(eg);
+}
+
+
+/* check that the working memory has been created for the size of the game */
+static void checkSize(const t_endgame* eg, const t_game* game) {
+	if (game->nbCells != eg->nbCells)
+		dispError(__FUNCTION__, "The game has %d cells instead of %d", game->nbCells, eg->nbCells);
+}
+
+
+/* --------------------------------------------------------------------------
+ * Indicates if the two snakes are separated, ie if the region reachable by
+ * a snake (through the free cells and its own body, that will be freed)
+ * does not intersect the one of its opponent
+ *
+ * Returns 1 if the snakes are separated, 0 otherwise
+ */
+int snakesSeparated(t_endgame* eg, const t_game* game) {
+	checkSize(eg, game);
+	snakeRegion(game, 0, eg->region, eg->queue);
+	snakeRegion(game, 1, eg->region2, eg->queue);
+	int separated = 1;
+	for (int c = 0; c < game->nbCells && separated; c++)
+		separated = eg->region[c] < 0 || eg->region2[c] < 0;
+	return separated;
+}
+
+
+/* Depth-first search from the local cell head, at move j
+ * Returns the maximal number of moves (that can be a lower bound if the search is interrupted),
+ * fills best with the best first move */
+static int explore(t_search* s, int head, int j, t_move* best) {
+	if (j >= s->horizon)
+		return 0;
+	if ((++s->nbNodes & 1023) == 0 && deadlinePassed(&s->deadline))
+		s->timeout = 1;
+	if (s->timeout)
+		return 0;
+	STAT_NODE();
+
+	/* memoized state? */
+	unsigned long long key = s->hash ^ mix(((unsigned long long) head << 32) | (unsigned int) j);
+	t_memo* m = &s->memo[key & ((1 << MEMO_BITS) - 1)];
+	if (best == NULL) {
+		int hit = m->generation == s->generation && m->key == key;
+		STAT_TT_PROBE(hit);
+		if (hit)
+			return m->length;
+	}
+
+	/* possible moves, ordered by their number of onward moves (we try first the cells with few exits) */
+	int cand[4], degree[4], nb = 0;
+	for (int d = 0; d < 4; d++) {
+		int c = s->next[4 * head + d];
+		if (c < 0 || s->release[c] > j + 1)
+			continue;
+		int k = 0;
+		for (int e = 0; e < 4; e++) {
+			int cc = s->next[4 * c + e];
+			k += cc >= 0 && s->release[cc] <= j + 2;
+		}
+		int i = nb++;
+		for (; i > 0 && degree[i - 1] > k; i--) {
+			cand[i] = cand[i - 1];
+			degree[i] = degree[i - 1];
+		}
+		cand[i] = d;
+		degree[i] = k;
+	}
+
+	int length = 0;
+	for (int i = 0; i < nb && length < s->horizon - j && !s->timeout; i++) {
+		/* the cell released at the move j+1 leaves the hash, the cell entered joins it */
+		int c = s->next[4 * head + cand[i]], t = s->freeAt[j + 1];
+		int tail = s->cellAt[j + 1], old = s->release[c];
+		unsigned long long change = (tail >= 0 && s->release[tail] == j + 1 ? cellKey(tail, j + 1) : 0) ^ cellKey(c, t);
+		int oldAt = t != INFINITE_TIME ? s->cellAt[t] : -1;
+		s->hash ^= change;
+		s->release[c] = t;
+		if (t != INFINITE_TIME)
+			s->cellAt[t] = c;
+
+		int l = 1 + explore(s, c, j + 1, NULL);
+
+		if (t != INFINITE_TIME)
+			s->cellAt[t] = oldAt;
+		s->release[c] = old;
+		s->hash ^= change;
+		if (l > length) {
+			length = l;
+			if (best)
+				*best = cand[i];
+		}
+	}
+
+	if (!s->timeout) {
+		STAT_TT_STORE(m->generation == s->generation && m->key != key);
+		m->key = key;
+		m->generation = s->generation;
+		m->length = length;
+	}
+	return length;
+}
+
+
+/* ------------------------------------------------------------------------------
+ * Compute the maximal number of moves the snake p can play in its region,
+ * taking into account the cells freed by its tail and its growth every 10 moves
+ * (branch-and-bound search with memoization of the visited states)
+ *
+ * Parameters:
+ * - eg: working memory
+ * - game: the game
+ * - p: the snake
+ * - budget: time budget (in seconds)
+ * - res: filled with the result
+ */
+void survival(t_endgame* eg, const t_game* game, int p, double budget, t_survival* res) {
+	t_search s;
+	checkSize(eg, game);
+	int *region = eg->region, *cells = eg->queue;
+	s.n = snakeRegion(game, p, region, cells);
+
+	/* the snake cannot play once its length exceeds the size of the region */
+	int nbMoves = game->snake[p].nbMoves;
+	s.horizon = 0;
+	while (snakeLength(nbMoves + s.horizon + 1) <= s.n)
+		s.horizon++;
+
+	/* nonGrowing[j]: number of non-growing moves among the moves 1..j
+	 * freeAt[j]: release time of a cell entered at move j (after as many non-growing moves as the length) */
+	int size = s.horizon + 2;
+	int* nonGrowing = eg->nonGrowing;
+	s.freeAt = eg->freeAt;
+	s.cellAt = eg->cellAt;
+	s.next = eg->next;
+	s.release = eg->release;
+	if (!eg->memo) {
+		eg->memo = calloc(1 << MEMO_BITS, sizeof(t_memo));
+		if (!eg->memo)
+			dispError(__FUNCTION__, "Cannot allocate the memoization table");
+	}
+	/* a new generation invalidates the entries of the previous searches (the table is cleared when it wraps) */
+	if (++eg->generation == 0) {
+		memset(eg->memo, 0, (1 << MEMO_BITS) * sizeof(t_memo));
+		eg->generation = 1;
+	}
+	s.memo = eg->memo;
+	s.generation = eg->generation;
+	nonGrowing[0] = 0;
+	for (int j = 1; j <= size; j++)
+		nonGrowing[j] = nonGrowing[j - 1] + ((nbMoves + j - 1) % GROWTH_PERIOD != 0);
+	for (int j = 0, k = 0; j <= size; j++) {
+		int target = nonGrowing[j] + snakeLength(nbMoves + j);
+		while (k <= size && nonGrowing[k] < target)
+			k++;
+		s.freeAt[j] = k <= size ? k : INFINITE_TIME;
+	}
+
+	/* local graph and release times of the body (the k-th cell from the tail is released by the (k+1)-th non-growing move) */
+	for (int i = 0; i < s.n; i++) {
+		for (int d = 0; d < 4; d++) {
+			int c = game->next[4 * cells[i] + d];
+			s.next[4 * i + d] = c >= 0 ? region[c] : -1;
+		}
+		s.release[i] = 0;
+	}
+	for (int t = 0; t <= size; t++)
+		s.cellAt[t] = -1;
+	int length = game->snake[p].length;
+	for (int k = 0, j = 0; k < length; k++) {
+		while (j <= size && nonGrowing[j] < k + 1)
+			j++;
+		int c = region[snakeCell(game, p, length - 1 - k)];
+		s.release[c] = j <= size ? j : INFINITE_TIME;
+		if (j <= size)
+			s.cellAt[j] = c;
+	}
+	s.hash = 0;
+	for (int i = 0; i < s.n; i++)
+		if (s.release[i] > 0)
+			s.hash ^= cellKey(i, s.release[i]);
+
+	/* search */
+	s.nbNodes = 0;
+	s.timeout = 0;
+	setDeadline(&s.deadline, budget);
+	res->move = NORTH;
+	res->length = explore(&s, region[snakeHead(game, p)], 0, &res->move);
+	res->exact = !s.timeout || res->length == s.horizon;
+	res->bound = res->exact ? res->length : s.horizon;
+	res->nbNodes = s.nbNodes;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Play the endgame: if the snakes are separated, compute the move that
+ * maximizes the survival of the player that has to play
+ *
+ * Parameters:
+ * - eg: working memory
+ * - game: the game
+ * - budget: time budget (in seconds)
+ * - move: filled with the move to play
+ *
+ * Returns 1 if the snakes are separated (and the move is given), 0 otherwise
+ */
+int endgameMove(t_endgame* eg, const t_game* game, double budget, t_move* move) {
+	if (!snakesSeparated(eg, game))
+		return 0;
+
+	int p = game->turn % 2;
+	t_survival res;
+	survival(eg, game, p, budget, &res);
+	dispDebug(__FUNCTION__, 1, "endgame: %d moves (%s, bound %d, %ld nodes)",
+		res.length, res.exact ? "exact" : "lower bound", res.bound, res.nbNodes);
+
+	/* no move to survive: play any legal move (or NORTH) */
+	if (res.length == 0) {
+		t_move moves[4];
+		res.move = legalMoves(game, moves) ? moves[0] : NORTH;
+	}
+	*move = res.move;
+	return 1;
+}
@@ -0,0 +1,116 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: endgame.h
+	Endgame solver, when the two snakes are in separated regions
+	(the snake that survives longer in its own region wins)
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_ENDGAME__
+#define __SNAKE_ENDGAME__
+#include "snakeGame.h"
+
+
+/* entry of the memoization table */
+typedef struct {
+	unsigned long long key;
+	unsigned int generation;	/* the entry is valid only for the search of this generation */
+	int length;					/* exact number of moves from the state */
+} t_memo;
+
+
+/* Working memory of the solver, allocated once for all the games of a given number of cells
+ * (the memoization table is allocated at the first survival computation) */
+typedef struct {
+	int nbCells;
+	int *region, *region2, *queue;	/* regions of the snakes (local indexes), and BFS queue */
+	int *next, *release;			/* local graph of the region, and release times of its cells */
+	int *nonGrowing, *freeAt, *cellAt;	/* arrays indexed by the move (GROWTH_PERIOD*nbCells+4 entries) */
+	t_memo* memo;
+	unsigned int generation;		/* incremented by each search, so that the table is never cleared */
+} t_endgame;
+
+
+/* Result of the survival computation of a snake in its region */
+typedef struct {
+	int length;		/* number of moves the snake can still play */
+	int exact;		/* 1 if the length is exact, 0 if it is only a lower bound (time budget exceeded) */
+	int bound;		/* upper bound of the number of moves */
+	t_move move;	/* first move of the longest path (meaningless when length is 0) */
+	long nbNodes;	/* number of nodes explored */
+} t_survival;
+
+
+
+/* ------------------------------------------------------------
+ * Create the working memory of the solver for a game (only its size is used)
+ *
+ * Returns the working memory (to be freed with `freeEndgame`)
+ */
+t_endgame* newEndgame(const t_game* game);
+
+
+/* ----------------------------------
+ * Free the working memory of the solver
+ */
+void freeEndgame(t_endgame* eg);
+
+
+/* --------------------------------------------------------------------------
+ * Indicates if the two snakes are separated, ie if the region reachable by
+ * a snake (through the free cells and its own body, that will be freed)
+ * does not intersect the one of its opponent
+ *
+ * Returns 1 if the snakes are separated, 0 otherwise
+ */
+int snakesSeparated(t_endgame* eg, const t_game* game);
+
+
+/* ------------------------------------------------------------------------------
+ * Compute the maximal number of moves the snake p can play in its region,
+ * taking into account the cells freed by its tail and its growth every 10 moves
+ * (branch-and-bound search with memoization of the visited states)
+ *
+ * Parameters:
+ * - eg: working memory
+ * - game: the game
+ * - p: the snake
+ * - budget: time budget (in seconds)
+ * - res: filled with the result
+ */
+void survival(t_endgame* eg, const t_game* game, int p, double budget, t_survival* res);
+
+
+/* ------------------------------------------------------------------------
+ * Play the endgame: if the snakes are separated, compute the move that
+ * maximizes the survival of the player that has to play
+ *
+ * Parameters:
+ * - eg: working memory
+ * - game: the game
+ * - budget: time budget (in seconds)
+ * - move: filled with the move to play
+ *
+ * Returns 1 if the snakes are separated (and the move is given), 0 otherwise
+ */
+int endgameMove(t_endgame* eg, const t_game* game, double budget, t_move* move);
+
+
+#endif
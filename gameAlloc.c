@@ -0,0 +1,174 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: gameAlloc.c
+	Memory allocator tied to the game: everything allocated during a game
+	is released at once when the game ends
+
+	snakeAPI.c calls `gameAllocBegin` and `gameAllocEnd` when it is compiled with
+	-DSNAKE_GAME_ALLOC (and gameAlloc.c, with -pthread); otherwise the program does it itself
+
+	A large range of virtual memory is reserved once; each thread takes blocks in it
+	(with an atomic increment) and allocates in its block by simply moving a pointer.
+	At the end of the game, the offset is set back to 0 and the generation is incremented,
+	so that the blocks of all the threads become invalid.
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <sys/mman.h>
+#include "clientAPI.h"
+#include "gameAlloc.h"
+
+
+#define GAME_TRIM_SIZE (64UL << 20)		/* the pages are given back to the system when a game has used more than that */
+
+
+static char* base = NULL;				/* reserved memory */
+static size_t offset = 0;				/* memory used by the current game */
+static unsigned int generation = 1;		/* number of the current game */
+static __thread t_allocMark local;		/* block of the current thread */
+
+
+
+/* reserve the virtual memory (only once) */
+static void reserve() {
+	if (__atomic_load_n(&base, __ATOMIC_ACQUIRE))
+		return;
+	char* mem = mmap(NULL, GAME_ARENA_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (mem == MAP_FAILED)
+		dispError(__FUNCTION__, "Cannot reserve the memory for the game");
+	char* expected = NULL;
+	if (!__atomic_compare_exchange_n(&base, &expected, mem, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		munmap(mem, GAME_ARENA_SIZE);
+}
+
+
+/* take a new block (of at least size bytes) for the current thread */
+static void newBlock(size_t size, unsigned int gen) {
+	reserve();
+	size_t bs = size > GAME_BLOCK_SIZE ? size : GAME_BLOCK_SIZE;
+	size_t off = __atomic_fetch_add(&offset, bs, __ATOMIC_RELAXED);
+	if (off + bs > GAME_ARENA_SIZE)
+		dispError(__FUNCTION__, "No more memory for the game (%lu bytes used)", off);
+	local.cur = base + off;
+	local.end = local.cur + bs;
+	local.generation = gen;
+}
+
+
+
+/* -----------------------------------------------------------------
+ * Start a new game (called by `waitForSnakeGame` with -DSNAKE_GAME_ALLOC): all the memory
+ * allocated during the previous game is released
+ */
+void gameAllocBegin() {
+	reserve();
+	gameAllocEnd();
+}
+
+
+/* ----------------------------------------------------------------
+ * End of the game (called when `sendMove` or `getMove` returns a winning or losing move)
+ * Release in O(1) all the memory allocated during the game
+ */
+void gameAllocEnd() {
+	size_t used = __atomic_exchange_n(&offset, 0, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&generation, 1, __ATOMIC_RELEASE);
+	if (used > GAME_TRIM_SIZE)
+		madvise(base, used, MADV_DONTNEED);
+	dispDebug(__FUNCTION__, 2, "%lu bytes released", used);
+}
+
+
+/* ---------------------------------------------------------------
+ * Allocate memory for the current game (thread-safe, each thread has its own blocks)
+ * The memory cannot be freed, it is released at the end of the game
+ *
+ * Parameters:
+ * - size: number of bytes
+ *
+ * Returns a pointer to the memory (aligned on 16 bytes, not initialized)
+ */
+void* gameAlloc(size_t size) {
+	size = (size + GAME_ALIGN - 1) & ~(size_t) (GAME_ALIGN - 1);
+	unsigned int gen = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+	if (local.generation != gen || local.cur + size > local.end)
+		newBlock(size, gen);
+	void* p = local.cur;
+	local.cur += size;
+	return p;
+}
+
+
+/* --------------------------------------------------------------------------
+ * Get the current position in the memory of the thread,
+ * and release all that the thread has allocated after it (scratch memory used for a turn)
+ */
+t_allocMark gameAllocMark() {
+	unsigned int gen = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+	if (local.generation != gen)
+		newBlock(0, gen);
+	return local;
+}
+
+void gameAllocRelease(t_allocMark mark) {
+	/* the blocks taken after the mark are lost until the end of the game */
+	if (mark.generation == __atomic_load_n(&generation, __ATOMIC_ACQUIRE))
+		local = mark;
+}
+
+
+/* --------------------------------------------------------------
+ * Returns the number of bytes used by the current game (all the threads)
+ */
+size_t gameAllocUsed() {
+	return __atomic_load_n(&offset, __ATOMIC_RELAXED);
+}
+
+
+/* ------------------------------------------------------------
+ * Allocate/free an element of a pool
+ */
+void* poolAlloc(t_pool* pool) {
+	unsigned int gen = __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+	if (pool->generation != gen) {
+		pool->freeList = NULL;
+		pool->generation = gen;
+	}
+	if (pool->freeList) {
+		void* e = pool->freeList;
+		pool->freeList = *(void**) e;
+		return e;
+	}
+	return gameAlloc(pool->size);
+}
+
+void poolFree(t_pool* pool, void* e) {
+	if (pool->generation != __atomic_load_n(&generation, __ATOMIC_ACQUIRE))
+		return;
+	*(void**) e = pool->freeList;
+	pool->freeList = e;
+}
+
+
+/* ------------------------------------------------------------
+ * Allocate a queue of n cells (for the BFS) for the current game
+ */
+int* gameAllocQueue(int n) {
+	return gameAlloc(n * sizeof(int));
+}
@@ -0,0 +1,131 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: gameAlloc.h
+	Memory allocator tied to the game: everything allocated during a game
+	is released at once when the game ends
+
+	snakeAPI.c calls `gameAllocBegin` and `gameAllocEnd` when it is compiled with
+	-DSNAKE_GAME_ALLOC (and gameAlloc.c, with -pthread); otherwise the program does it itself
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_GAME_ALLOC__
+#define __SNAKE_GAME_ALLOC__
+#include <stddef.h>
+#include "snakeAPI.h"
+
+
+#ifndef GAME_ARENA_SIZE
+#define GAME_ARENA_SIZE (1UL << 30)		/* virtual memory reserved for a game (only the used pages are really allocated) */
+#endif
+#define GAME_BLOCK_SIZE (1UL << 20)		/* size of the blocks given to each thread */
+#define GAME_ALIGN 16					/* alignment of the allocated memory */
+
+
+/* Position in the memory of the current thread (to release all that has been allocated after it) */
+typedef struct {
+	char* cur;
+	char* end;
+	unsigned int generation;
+} t_allocMark;
+
+
+/* Pool of elements of the same size (not thread-safe, one pool per thread)
+ * the freed elements are kept in a list to be reused, the pool is emptied at the end of the game */
+typedef struct {
+	size_t size;			/* size of an element */
+	void* freeList;			/* list of freed elements */
+	unsigned int generation;	/* game of the elements of the free list */
+} t_pool;
+
+/* initializer of a pool of elements of a given type */
+#define POOL_INIT(type) { sizeof(type) < sizeof(void*) ? sizeof(void*) : sizeof(type), NULL, 0 }
+
+/* define the functions `nameAlloc` and `nameFree` for a typed pool */
+#define DEFINE_POOL(name, type) \
+	static inline type* name##Alloc(t_pool* pool) { return (type*) poolAlloc(pool); } \
+	static inline void name##Free(t_pool* pool, type* e) { poolFree(pool, e); }
+
+
+/* Move list (used by the search algorithms) */
+typedef struct {
+	int nb;
+	t_move moves[4];
+} t_moveList;
+
+
+
+/* -----------------------------------------------------------------
+ * Start a new game (called by `waitForSnakeGame` with -DSNAKE_GAME_ALLOC): all the memory
+ * allocated during the previous game is released
+ */
+void gameAllocBegin();
+
+
+/* ----------------------------------------------------------------
+ * End of the game (called when `sendMove` or `getMove` returns a winning or losing move)
+ * Release in O(1) all the memory allocated during the game
+ */
+void gameAllocEnd();
+
+
+/* ---------------------------------------------------------------
+ * Allocate memory for the current game (thread-safe, each thread has its own blocks)
+ * The memory cannot be freed, it is released at the end of the game
+ *
+ * Parameters:
+ * - size: number of bytes
+ *
+ * Returns a pointer to the memory (aligned on 16 bytes, not initialized)
+ */
+void* gameAlloc(size_t size);
+
+
+/* --------------------------------------------------------------------------
+ * Get the current position in the memory of the thread,
+ * and release all that the thread has allocated after it (scratch memory used for a turn)
+ */
+t_allocMark gameAllocMark();
+void gameAllocRelease(t_allocMark mark);
+
+
+/* --------------------------------------------------------------
+ * Returns the number of bytes used by the current game (all the threads)
+ */
+size_t gameAllocUsed();
+
+
+/* ------------------------------------------------------------
+ * Allocate/free an element of a pool
+ */
+void* poolAlloc(t_pool* pool);
+void poolFree(t_pool* pool, void* e);
+
+
+/* ------------------------------------------------------------
+ * Allocate a queue of n cells (for the BFS) for the current game
+ */
+int* gameAllocQueue(int n);
+
+
+DEFINE_POOL(moveList, t_moveList)
+
+
+#endif
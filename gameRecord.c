@@ -0,0 +1,610 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: gameRecord.c
+	Binary store of game records (writer, and reader mapped in memory)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "clientAPI.h"
+#include "gameRecord.h"
+
+
+/* grow an array (to at least n elements) */
+static void* grow(void* array, uint64_t n, uint64_t* size, size_t elem) {
+	if (n <= *size)
+		return array;
+	uint64_t s = *size ? *size : 64;
+	while (s < n)
+		s *= 2;
+	array = realloc(array, s * elem);
+	if (!array)
+		dispError(__FUNCTION__, "Cannot allocate the records");
+	*size = s;
+	return array;
+}
+
+
+/* FNV-1a hash */
+static uint64_t hashBytes(uint64_t h, const uint8_t* p, size_t n) {
+	for (size_t i = 0; i < n; i++)
+		h = (h ^ p[i]) * 0x100000001B3ULL;
+	return h;
+}
+
+
+/* seed of a game, given by the 6 last hexadecimal digits of its name */
+static uint32_t nameSeed(const char* name) {
+	size_t n = strlen(name);
+	if (n < 6)
+		return RECORD_NO_SEED;
+	char* end;
+	unsigned long seed = strtoul(name + n - 6, &end, 16);
+	return *end ? RECORD_NO_SEED : (uint32_t) seed;
+}
+
+
+/* number of bytes of the walls of an arena */
+static size_t wallBytes(int sizeX, int sizeY) {
+	return (2 * (size_t) sizeX * sizeY + 7) / 8;
+}
+
+
+/* check that the columns of the games point inside their sections
+ * (arena, walls of the arenas, moves, names and indexes), in O(nbGames) */
+static int checkColumns(const uint8_t* map, const t_recordHeader* head) {
+	const uint64_t* off = head->offset;
+	uint64_t wallsSize = off[SEC_WALLS + 1] - off[SEC_WALLS];
+	uint64_t movesSize = off[SEC_MOVES + 1] - off[SEC_MOVES];
+	uint64_t namesSize = off[SEC_NAMES + 1] - off[SEC_NAMES];
+	const t_recordArena* arenas = (const t_recordArena*) (map + off[SEC_ARENAS]);
+	for (uint32_t a = 0; a < head->nbArenas; a++) {
+		const t_recordArena* ar = &arenas[a];
+		if (ar->sizeX < 5 || !ar->sizeY || ar->walls > wallsSize || wallBytes(ar->sizeX, ar->sizeY) > wallsSize - ar->walls)
+			return 0;
+	}
+	const uint32_t* arena = (const uint32_t*) (map + off[SEC_GAME_ARENA]);
+	const uint32_t* nbMoves = (const uint32_t*) (map + off[SEC_GAME_NB_MOVES]);
+	const uint64_t* movesOffset = (const uint64_t*) (map + off[SEC_GAME_MOVES]);
+	const uint32_t* name = (const uint32_t*) (map + off[SEC_GAME_NAME]);
+	const char* names = (const char*) (map + off[SEC_NAMES]);
+	const uint32_t* bySeed = (const uint32_t*) (map + off[SEC_INDEX_SEED]);
+	const uint32_t* byName = (const uint32_t*) (map + off[SEC_INDEX_NAME]);
+	for (uint32_t g = 0; g < head->nbGames; g++) {
+		if (arena[g] >= head->nbArenas || bySeed[g] >= head->nbGames || byName[g] >= head->nbGames)
+			return 0;
+		if (movesOffset[g] > movesSize || ((uint64_t) nbMoves[g] + 3) / 4 > movesSize - movesOffset[g])
+			return 0;
+		/* the name must be terminated inside SEC_NAMES */
+		if (name[g] >= namesSize || !memchr(names + name[g], 0, namesSize - name[g]))
+			return 0;
+	}
+	return 1;
+}
+
+
+/* ---------------------------------------------------------------------
+ * Create a record file (it is complete only after `recordClose`)
+ *
+ * Returns the writer, NULL if the file cannot be created
+ */
+t_recordWriter* recordCreate(const char* fileName) {
+	FILE* f = fopen(fileName, "wb");
+	if (!f)
+		return NULL;
+	t_recordWriter* w = calloc(1, sizeof(t_recordWriter));
+	if (!w)
+		dispError(__FUNCTION__, "Cannot allocate the writer");
+	w->file = f;
+	w->fileName = strdup(fileName);
+	w->sizeHash = 64;
+	w->hash = calloc(w->sizeHash, sizeof(uint32_t));
+	if (!w->fileName || !w->hash)
+		dispError(__FUNCTION__, "Cannot allocate the writer");
+	/* the header is written at the end, the move streams come first */
+	t_recordHeader head;
+	memset(&head, 0, sizeof(head));
+	fwrite(&head, sizeof(head), 1, f);
+	return w;
+}
+
+
+/* index of an arena (added if it is new) */
+static uint32_t addArena(t_recordWriter* w, int sizeX, int sizeY, const uint8_t* walls) {
+	size_t n = wallBytes(sizeX, sizeY);
+	uint16_t sizes[2] = {sizeX, sizeY};
+	uint64_t h = hashBytes(hashBytes(0xCBF29CE484222325ULL, (const uint8_t*) sizes, sizeof(sizes)), walls, n);
+	uint32_t mask = w->sizeHash - 1;
+	for (uint32_t i = h & mask; w->hash[i]; i = (i + 1) & mask) {
+		uint32_t a = w->hash[i] - 1;
+		const t_recordArena* ar = &w->arenas[a];
+		if (w->arenaHash[a] == h && ar->sizeX == sizeX && ar->sizeY == sizeY && memcmp(w->walls + ar->walls, walls, n) == 0)
+			return a;
+	}
+
+	/* new arena */
+	uint64_t size = w->sizeArenas;
+	w->arenas = grow(w->arenas, w->nbArenas + 1, &size, sizeof(t_recordArena));
+	size = w->sizeArenas;
+	w->arenaHash = grow(w->arenaHash, w->nbArenas + 1, &size, sizeof(uint64_t));
+	w->sizeArenas = size;
+	w->walls = grow(w->walls, w->nbWalls + n, &w->sizeWalls, 1);
+	t_recordArena* ar = &w->arenas[w->nbArenas];
+	memset(ar, 0, sizeof(t_recordArena));
+	ar->sizeX = sizeX;
+	ar->sizeY = sizeY;
+	ar->walls = w->nbWalls;
+	memcpy(w->walls + w->nbWalls, walls, n);
+	w->nbWalls += n;
+	w->arenaHash[w->nbArenas] = h;
+	w->nbArenas++;
+
+	/* the hash table is kept at most half full */
+	if (2 * w->nbArenas > w->sizeHash) {
+		free(w->hash);
+		w->sizeHash *= 2;
+		w->hash = calloc(w->sizeHash, sizeof(uint32_t));
+		if (!w->hash)
+			dispError(__FUNCTION__, "Cannot allocate the hash table");
+		for (uint32_t a = 0; a < w->nbArenas; a++) {
+			uint32_t i = w->arenaHash[a] & (w->sizeHash - 1);
+			while (w->hash[i])
+				i = (i + 1) & (w->sizeHash - 1);
+			w->hash[i] = a + 1;
+		}
+	}
+	else {
+		uint32_t i = h & mask;
+		while (w->hash[i])
+			i = (i + 1) & mask;
+		w->hash[i] = w->nbArenas;
+	}
+	return w->nbArenas - 1;
+}
+
+
+/* write the moves of the current game and add it to the columns */
+static void endGame(t_recordWriter* w, int result) {
+	uint32_t g = w->nbGames;
+	uint64_t nb = (w->turn + 3) / 4;
+	fwrite(w->moves, 1, nb, w->file);
+	w->movesOffset[g] = w->nbBytes;
+	w->nbBytes += nb;
+	w->result[g] = result;
+	w->nbMoves[g] = w->turn;
+	w->nbGames++;
+	w->playing = 0;
+}
+
+
+/* -------------------------------------------------------------------------
+ * Begin the record of a game (a game not ended is recorded as REC_UNFINISHED)
+ *
+ * Parameters:
+ * - w: the writer
+ * - gameName: name of the game (the seed is given by its 6 last hexadecimal digits)
+ * - sizeX, sizeY, nbWalls, walls: the arena (as given by `waitForSnakeGame` and `getSnakeArena`)
+ * - player: the player we are (as returned by `getSnakeArena`: 0 if we start)
+ */
+void recordBeginGame(t_recordWriter* w, const char* gameName, int sizeX, int sizeY, int nbWalls, const int* walls, int player) {
+	if (w->playing)
+		endGame(w, REC_UNFINISHED);
+
+	/* walls of the arena: 2 bits by cell (east, south) */
+	t_game* game = newGame(sizeX, sizeY, nbWalls, walls);
+	size_t n = wallBytes(sizeX, sizeY);
+	uint8_t* bits = calloc(n, 1);
+	if (!bits)
+		dispError(__FUNCTION__, "Cannot allocate the walls");
+	for (int y = 0; y < sizeY; y++)
+		for (int x = 0; x < sizeX; x++) {
+			int c = CELL(game, x, y);
+			if (x + 1 < sizeX && game->next[4 * c + EAST] < 0)
+				bits[(2 * c) >> 3] |= 1 << ((2 * c) & 7);
+			if (y + 1 < sizeY && game->next[4 * c + SOUTH] < 0)
+				bits[(2 * c + 1) >> 3] |= 1 << ((2 * c + 1) & 7);
+		}
+	freeGame(game);
+
+	/* columns of the new game */
+	uint32_t g = w->nbGames;
+	uint64_t size = w->sizeGames;
+	w->arena = grow(w->arena, g + 1, &size, sizeof(uint32_t));
+	size = w->sizeGames;
+	w->seed = grow(w->seed, g + 1, &size, sizeof(uint32_t));
+	size = w->sizeGames;
+	w->result = grow(w->result, g + 1, &size, sizeof(uint8_t));
+	size = w->sizeGames;
+	w->playerCol = grow(w->playerCol, g + 1, &size, sizeof(uint8_t));
+	size = w->sizeGames;
+	w->nbMoves = grow(w->nbMoves, g + 1, &size, sizeof(uint32_t));
+	size = w->sizeGames;
+	w->movesOffset = grow(w->movesOffset, g + 1, &size, sizeof(uint64_t));
+	size = w->sizeGames;
+	w->name = grow(w->name, g + 1, &size, sizeof(uint32_t));
+	w->sizeGames = size;
+
+	w->arena[g] = addArena(w, sizeX, sizeY, bits);
+	free(bits);
+	w->seed[g] = nameSeed(gameName);
+	w->playerCol[g] = player;
+	size_t len = strlen(gameName) + 1;
+	w->names = grow(w->names, w->nbNames + len, &w->sizeNames, 1);
+	memcpy(w->names + w->nbNames, gameName, len);
+	w->name[g] = w->nbNames;
+	w->nbNames += len;
+
+	w->player = player;
+	w->turn = 0;
+	w->playing = 1;
+}
+
+
+/* -----------------------------------------------------
+ * Add a move (played by the player that has to play)
+ */
+void recordMove(t_recordWriter* w, t_move move) {
+	if (!w->playing)
+		return;
+	if (w->turn / 4 >= w->sizeMoves) {
+		w->sizeMoves = w->sizeMoves ? 2 * w->sizeMoves : 256;
+		w->moves = realloc(w->moves, w->sizeMoves);
+		if (!w->moves)
+			dispError(__FUNCTION__, "Cannot allocate the moves");
+	}
+	int k = w->turn++;
+	if ((k & 3) == 0)
+		w->moves[k >> 2] = 0;
+	w->moves[k >> 2] |= (move & 3) << (2 * (k & 3));
+}
+
+
+/* -------------------------------------------------------------
+ * End the game (winner: 0 or 1, reason: REC_BLOCKED or REC_LOST)
+ */
+void recordEndGame(t_recordWriter* w, int winner, int reason) {
+	if (w->playing)
+		endGame(w, winner | reason << 2);
+}
+
+
+/* ------------------------------------------------------------------------------------
+ * Function to give to `addMoveListener` (data is the writer): records the moves sent
+ * and received, and ends the game with the last one (after `recordBeginGame`)
+ */
+void recordListener(t_move move, int ours, t_return_code ret, void* data) {
+	t_recordWriter* w = data;
+	if (!w->playing)
+		return;
+	recordMove(w, move);
+	/* the return code is relative to the player that has played */
+	int p = ours ? w->player : 1 - w->player;
+	if (ret == WINNING_MOVE)
+		recordEndGame(w, p, REC_BLOCKED);
+	else if (ret == LOSING_MOVE)
+		recordEndGame(w, 1 - p, REC_LOST);
+}
+
+
+/* a game and its sort key, to build the indexes */
+typedef struct {
+	const char* name;
+	uint32_t seed;
+	uint32_t game;
+} t_sortKey;
+
+static int cmpSeed(const void* a, const void* b) {
+	const t_sortKey *x = a, *y = b;
+	if (x->seed != y->seed)
+		return x->seed < y->seed ? -1 : 1;
+	return x->game < y->game ? -1 : x->game > y->game;
+}
+
+static int cmpName(const void* a, const void* b) {
+	const t_sortKey *x = a, *y = b;
+	int c = strcmp(x->name, y->name);
+	return c ? c : (x->game < y->game ? -1 : x->game > y->game);
+}
+
+
+/* write a section (aligned on 8 bytes) */
+static void writeSection(t_recordWriter* w, t_recordHeader* head, int s, const void* data, uint64_t size) {
+	static const char zeros[8] = {0};
+	uint64_t pos = ftell(w->file);
+	if (pos % 8)
+		pos += fwrite(zeros, 1, 8 - pos % 8, w->file);
+	head->offset[s] = pos;
+	if (size)
+		fwrite(data, 1, size, w->file);
+}
+
+
+/* ---------------------------------------------------------------------
+ * Write the tables and the indexes, and close the file
+ *
+ * Returns 0 if the file has been written, -1 otherwise
+ */
+int recordClose(t_recordWriter* w) {
+	if (!w)
+		return -1;
+	if (w->playing)
+		endGame(w, REC_UNFINISHED);
+	uint32_t n = w->nbGames;
+
+	/* indexes */
+	t_sortKey* keys = malloc((n ? n : 1) * sizeof(t_sortKey));
+	uint32_t* bySeed = malloc((n ? n : 1) * sizeof(uint32_t));
+	uint32_t* byName = malloc((n ? n : 1) * sizeof(uint32_t));
+	if (!keys || !bySeed || !byName)
+		dispError(__FUNCTION__, "Cannot allocate the indexes");
+	for (uint32_t g = 0; g < n; g++) {
+		keys[g].name = w->names + w->name[g];
+		keys[g].seed = w->seed[g];
+		keys[g].game = g;
+	}
+	qsort(keys, n, sizeof(t_sortKey), cmpSeed);
+	for (uint32_t g = 0; g < n; g++)
+		bySeed[g] = keys[g].game;
+	qsort(keys, n, sizeof(t_sortKey), cmpName);
+	for (uint32_t g = 0; g < n; g++)
+		byName[g] = keys[g].game;
+
+	t_recordHeader head;
+	memset(&head, 0, sizeof(head));
+	memcpy(head.magic, RECORD_MAGIC, 8);
+	head.version = RECORD_VERSION;
+	head.nbGames = n;
+	head.nbArenas = w->nbArenas;
+	head.offset[SEC_MOVES] = sizeof(t_recordHeader);
+	writeSection(w, &head, SEC_ARENAS, w->arenas, w->nbArenas * sizeof(t_recordArena));
+	writeSection(w, &head, SEC_WALLS, w->walls, w->nbWalls);
+	writeSection(w, &head, SEC_GAME_ARENA, w->arena, n * sizeof(uint32_t));
+	writeSection(w, &head, SEC_GAME_SEED, w->seed, n * sizeof(uint32_t));
+	writeSection(w, &head, SEC_GAME_RESULT, w->result, n);
+	writeSection(w, &head, SEC_GAME_PLAYER, w->playerCol, n);
+	writeSection(w, &head, SEC_GAME_NB_MOVES, w->nbMoves, n * sizeof(uint32_t));
+	writeSection(w, &head, SEC_GAME_MOVES, w->movesOffset, n * sizeof(uint64_t));
+	writeSection(w, &head, SEC_GAME_NAME, w->name, n * sizeof(uint32_t));
+	writeSection(w, &head, SEC_NAMES, w->names, w->nbNames);
+	writeSection(w, &head, SEC_INDEX_SEED, bySeed, n * sizeof(uint32_t));
+	writeSection(w, &head, SEC_INDEX_NAME, byName, n * sizeof(uint32_t));
+	writeSection(w, &head, NB_SECTIONS, NULL, 0);
+	fseek(w->file, 0, SEEK_SET);
+	fwrite(&head, sizeof(head), 1, w->file);
+	int ret = ferror(w->file) | fclose(w->file) ? -1 : 0;
+	if (ret < 0)
+		dispDebug(__FUNCTION__, 0, "Cannot write the records %s", w->fileName);
+
+	free(keys);
+	free(bySeed);
+	free(byName);
+	free(w->fileName);
+	free(w->moves);
+	free(w->arenas);
+	free(w->arenaHash);
+	free(w->walls);
+	free(w->hash);
+	free(w->arena);
+	free(w->seed);
+	free(w->result);
+	free(w->playerCol);
+	free(w->nbMoves);
+	free(w->movesOffset);
+	free(w->name);
+	free(w->names);
+	free(w);
+	return ret;
+}
+
+
+/* ------------------------------------------------------------------
+ * Open a record file (mapped in memory)
+ * The header, the sections and the columns are checked (arenas, walls, moves and
+ * names inside their sections), so that the reader can then trust the file
+ *
+ * Returns the reader, NULL if the file cannot be read or is invalid
+ */
+t_recordReader* recordOpen(const char* fileName) {
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(t_recordHeader)) {
+		close(fd);
+		return NULL;
+	}
+	const uint8_t* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	/* check the header and the sizes of the sections */
+	const t_recordHeader* head = (const t_recordHeader*) map;
+	const uint64_t* off = head->offset;
+	uint64_t n = head->nbGames;
+	int valid = memcmp(head->magic, RECORD_MAGIC, 8) == 0 && head->version == RECORD_VERSION
+		&& off[NB_SECTIONS] == (uint64_t) st.st_size && off[SEC_MOVES] == sizeof(t_recordHeader);
+	for (int s = 0; valid && s < NB_SECTIONS; s++)
+		valid = off[s] <= off[s + 1] && (s == SEC_MOVES || off[s] % 8 == 0);
+	static const int colSize[NB_SECTIONS] = {
+		[SEC_GAME_ARENA] = 4, [SEC_GAME_SEED] = 4, [SEC_GAME_RESULT] = 1, [SEC_GAME_PLAYER] = 1,
+		[SEC_GAME_NB_MOVES] = 4, [SEC_GAME_MOVES] = 8, [SEC_GAME_NAME] = 4, [SEC_INDEX_SEED] = 4, [SEC_INDEX_NAME] = 4
+	};
+	for (int s = 0; valid && s < NB_SECTIONS; s++)
+		if (colSize[s])
+			valid = off[s + 1] - off[s] >= n * colSize[s];
+	valid = valid && off[SEC_WALLS] - off[SEC_ARENAS] >= head->nbArenas * sizeof(t_recordArena);
+	valid = valid && checkColumns(map, head);
+	if (!valid) {
+		munmap((void*) map, st.st_size);
+		return NULL;
+	}
+
+	t_recordReader* r = malloc(sizeof(t_recordReader));
+	if (!r)
+		dispError(__FUNCTION__, "Cannot allocate the reader");
+	r->map = map;
+	r->size = st.st_size;
+	r->nbGames = head->nbGames;
+	r->nbArenas = head->nbArenas;
+	r->moves = map + off[SEC_MOVES];
+	r->arenas = (const t_recordArena*) (map + off[SEC_ARENAS]);
+	r->walls = map + off[SEC_WALLS];
+	r->arena = (const uint32_t*) (map + off[SEC_GAME_ARENA]);
+	r->seed = (const uint32_t*) (map + off[SEC_GAME_SEED]);
+	r->result = map + off[SEC_GAME_RESULT];
+	r->player = map + off[SEC_GAME_PLAYER];
+	r->nbMoves = (const uint32_t*) (map + off[SEC_GAME_NB_MOVES]);
+	r->movesOffset = (const uint64_t*) (map + off[SEC_GAME_MOVES]);
+	r->name = (const uint32_t*) (map + off[SEC_GAME_NAME]);
+	r->names = (const char*) (map + off[SEC_NAMES]);
+	r->bySeed = (const uint32_t*) (map + off[SEC_INDEX_SEED]);
+	r->byName = (const uint32_t*) (map + off[SEC_INDEX_NAME]);
+	madvise((void*) map, st.st_size, MADV_SEQUENTIAL);
+	return r;
+}
+
+
+/* -------------------
+ * Close a record file
+ */
+void recordFree(t_recordReader* r) {
+	if (!r)
+		return;
+	munmap((void*) r->map, r->size);
+	free(r);
+}
+
+
+/* --------------------------------------------------------------------
+ * Build the starting position of the game g
+ *
+ * Returns the game (to be freed with `freeGame`)
+ */
+t_game* recordGame(const t_recordReader* r, uint32_t g) {
+	const t_recordArena* ar = &r->arenas[r->arena[g]];
+	const uint8_t* bits = r->walls + ar->walls;
+	int nbCells = ar->sizeX * ar->sizeY, nb = 0;
+	int* walls = malloc(8 * nbCells * sizeof(int));
+	if (!walls)
+		dispError(__FUNCTION__, "Cannot allocate the walls");
+	for (int c = 0; c < nbCells; c++) {
+		int x = c % ar->sizeX, y = c / ar->sizeX;
+		for (int s = 0; s < 2; s++)
+			if ((bits[(2 * c + s) >> 3] >> ((2 * c + s) & 7)) & 1) {
+				int* w = walls + 4 * nb++;
+				w[0] = x; w[1] = y; w[2] = x + !s; w[3] = y + s;
+			}
+	}
+	t_game* game = newGame(ar->sizeX, ar->sizeY, nb, walls);
+	free(walls);
+	return game;
+}
+
+
+/* -------------------------------------------------------------------------
+ * Games of a given seed: they are bySeed[first] ... bySeed[first+nb-1]
+ *
+ * Returns nb (0 if there is none)
+ */
+int recordFindSeed(const t_recordReader* r, uint32_t seed, uint32_t* first) {
+	uint32_t lo = 0, hi = r->nbGames;
+	while (lo < hi) {
+		uint32_t m = lo + (hi - lo) / 2;
+		if (r->seed[r->bySeed[m]] < seed)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	*first = lo;
+	uint32_t k = lo;
+	while (k < r->nbGames && r->seed[r->bySeed[k]] == seed)
+		k++;
+	return k - lo;
+}
+
+
+/* -------------------------------------------------------------------------
+ * Find a game by its name
+ *
+ * Returns its index, or -1 if there is none
+ */
+long recordFindName(const t_recordReader* r, const char* name) {
+	uint32_t lo = 0, hi = r->nbGames;
+	while (lo < hi) {
+		uint32_t m = lo + (hi - lo) / 2;
+		if (strcmp(recordGameName(r, r->byName[m]), name) < 0)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	if (lo < r->nbGames && strcmp(recordGameName(r, r->byName[lo]), name) == 0)
+		return r->byName[lo];
+	return -1;
+}
+
+
+/* ---------------------------------------------------------------------------------
+ * Iterate on the positions of the game g: after `recordIterBegin`, each call to
+ * `recordIterNext` gives the next move, it->pos being the position before it
+ * (the iterator can be reused for several games, it keeps the last arena)
+ */
+void recordIterInit(t_recordIter* it, const t_recordReader* r) {
+	it->rec = r;
+	it->arena = UINT32_MAX;
+	it->start = it->pos = NULL;
+	it->game = 0;
+	it->k = 0;
+}
+
+void recordIterBegin(t_recordIter* it, uint32_t g) {
+	const t_recordReader* r = it->rec;
+	if (r->arena[g] != it->arena) {
+		freeGame(it->start);
+		freeGame(it->pos);
+		it->start = recordGame(r, g);
+		it->pos = newGame(it->start->sizeX, it->start->sizeY, 0, NULL);
+		it->arena = r->arena[g];
+	}
+	copyGame(it->pos, it->start);
+	it->game = g;
+	it->k = 0;
+}
+
+int recordIterNext(t_recordIter* it, t_move* move) {
+	const t_recordReader* r = it->rec;
+	if (it->k >= r->nbMoves[it->game])
+		return 0;
+	if (it->k > 0 && playGameMove(it->pos, recordGameMove(r, it->game, it->k - 1), NULL) != NORMAL_MOVE)
+		return 0;
+	*move = recordGameMove(r, it->game, it->k++);
+	return 1;
+}
+
+void recordIterFree(t_recordIter* it) {
+	freeGame(it->start);
+	freeGame(it->pos);
+	it->start = it->pos = NULL;
+	it->arena = UINT32_MAX;
+}
@@ -0,0 +1,284 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: gameRecord.h
+	Binary store of game records: a game is fully described by its arena, the player
+	we were, its result and its moves (2 bits each)
+
+	The file is made of a header and of sections (aligned on 8 bytes):
+	- the move streams (4 moves by byte, each game starts on a new byte)
+	- the table of the arenas (deduplicated) and their walls (2 bits by cell: wall on the east, wall on the south)
+	- one column by field of the games (arena, seed, result, player, number of moves, offset of the moves, name)
+	- the names of the games
+	- the indexes: the games sorted by seed, and sorted by name
+	The reader maps the file in memory (mmap) and reads everything in place
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_GAME_RECORD__
+#define __SNAKE_GAME_RECORD__
+#include <stdio.h>
+#include <stdint.h>
+#include "snakeGame.h"
+#include "snakeAPI.h"
+
+
+#define RECORD_MAGIC "SNAKEREC"
+#define RECORD_VERSION 1
+
+
+/* result of a game */
+enum {
+	REC_WIN0 = 0,			/* the player 0 has won */
+	REC_WIN1 = 1,			/* the player 1 has won */
+	REC_UNFINISHED = 2		/* the game was not over when it was recorded */
+};
+
+/* reason of the end of a game (result >> 2) */
+enum {
+	REC_BLOCKED = 0,		/* the last move has blocked the opponent (WINNING_MOVE) */
+	REC_LOST = 1			/* the last move has lost (illegal move, or timeout) */
+};
+
+#define RECORD_WINNER(result) ((result) & 3)
+#define RECORD_REASON(result) ((result) >> 2)
+
+
+/* sections of the file */
+enum {
+	SEC_MOVES,
+	SEC_ARENAS,				/* t_recordArena[nbArenas] */
+	SEC_WALLS,				/* walls of the arenas */
+	SEC_GAME_ARENA,			/* uint32_t[nbGames] */
+	SEC_GAME_SEED,			/* uint32_t[nbGames] (RECORD_NO_SEED if unknown) */
+	SEC_GAME_RESULT,		/* uint8_t[nbGames] (winner | reason << 2) */
+	SEC_GAME_PLAYER,		/* uint8_t[nbGames] (the player we were) */
+	SEC_GAME_NB_MOVES,		/* uint32_t[nbGames] */
+	SEC_GAME_MOVES,			/* uint64_t[nbGames] (offset in SEC_MOVES) */
+	SEC_GAME_NAME,			/* uint32_t[nbGames] (offset in SEC_NAMES) */
+	SEC_NAMES,
+	SEC_INDEX_SEED,			/* uint32_t[nbGames] (games sorted by seed) */
+	SEC_INDEX_NAME,			/* uint32_t[nbGames] (games sorted by name) */
+	NB_SECTIONS
+};
+
+#define RECORD_NO_SEED 0xFFFFFFFFu
+
+
+/* header of the file */
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t nbGames;
+	uint32_t nbArenas;
+	uint32_t reserved;
+	uint64_t offset[NB_SECTIONS + 1];	/* offset of each section in the file (offset[NB_SECTIONS] is the size of the file) */
+} t_recordHeader;
+
+
+/* an arena */
+typedef struct {
+	uint16_t sizeX, sizeY;
+	uint32_t reserved;
+	uint64_t walls;			/* offset of its walls in SEC_WALLS */
+} t_recordArena;
+
+
+/* The writer (the games are added one by one, the moves are written as they come,
+ * the tables at the end by `recordClose`) */
+typedef struct {
+	FILE* file;
+	char* fileName;
+	uint64_t nbBytes;				/* size of the move streams written */
+	/* current game */
+	int playing;					/* 1 if a game is being recorded */
+	int player;						/* the player we are (0 if we start) */
+	int turn;
+	uint8_t* moves;
+	int sizeMoves;
+	/* arenas (the hash table gives the index+1 of an arena, 0 if empty) */
+	t_recordArena* arenas;
+	uint64_t* arenaHash;
+	uint8_t* walls;
+	uint64_t nbWalls, sizeWalls;
+	uint32_t nbArenas, sizeArenas;
+	uint32_t* hash;
+	uint32_t sizeHash;
+	/* columns of the games */
+	uint32_t nbGames, sizeGames;
+	uint32_t* arena;
+	uint32_t* seed;
+	uint8_t* result;
+	uint8_t* playerCol;
+	uint32_t* nbMoves;
+	uint64_t* movesOffset;
+	uint32_t* name;
+	char* names;
+	uint64_t nbNames, sizeNames;
+} t_recordWriter;
+
+
+/* The reader (everything points in the mapped file) */
+typedef struct {
+	const uint8_t* map;
+	size_t size;
+	uint32_t nbGames, nbArenas;
+	const uint8_t* moves;
+	const t_recordArena* arenas;
+	const uint8_t* walls;
+	const uint32_t* arena;
+	const uint32_t* seed;
+	const uint8_t* result;
+	const uint8_t* player;
+	const uint32_t* nbMoves;
+	const uint64_t* movesOffset;
+	const uint32_t* name;
+	const char* names;
+	const uint32_t* bySeed;
+	const uint32_t* byName;
+} t_recordReader;
+
+
+/* Iterator on the positions of a game (see `recordIterBegin`) */
+typedef struct {
+	const t_recordReader* rec;
+	uint32_t game;
+	uint32_t arena;			/* arena of `start` (UINT32_MAX if none) */
+	t_game* start;			/* starting position of the arena (cached) */
+	t_game* pos;			/* current position */
+	uint32_t k;				/* index of the next move */
+} t_recordIter;
+
+
+
+/* ---------------------------------------------------------------------
+ * Create a record file (it is complete only after `recordClose`)
+ *
+ * Returns the writer, NULL if the file cannot be created
+ */
+t_recordWriter* recordCreate(const char* fileName);
+
+
+/* -------------------------------------------------------------------------
+ * Begin the record of a game (a game not ended is recorded as REC_UNFINISHED)
+ *
+ * Parameters:
+ * - w: the writer
+ * - gameName: name of the game (the seed is given by its 6 last hexadecimal digits)
+ * - sizeX, sizeY, nbWalls, walls: the arena (as given by `waitForSnakeGame` and `getSnakeArena`)
+ * - player: the player we are (as returned by `getSnakeArena`: 0 if we start)
+ */
+void recordBeginGame(t_recordWriter* w, const char* gameName, int sizeX, int sizeY, int nbWalls, const int* walls, int player);
+
+
+/* -----------------------------------------------------
+ * Add a move (played by the player that has to play)
+ */
+void recordMove(t_recordWriter* w, t_move move);
+
+
+/* -------------------------------------------------------------
+ * End the game (winner: 0 or 1, reason: REC_BLOCKED or REC_LOST)
+ */
+void recordEndGame(t_recordWriter* w, int winner, int reason);
+
+
+/* ------------------------------------------------------------------------------------
+ * Function to give to `addMoveListener` (data is the writer): records the moves sent
+ * and received, and ends the game with the last one (after `recordBeginGame`)
+ */
+void recordListener(t_move move, int ours, t_return_code ret, void* data);
+
+
+/* ---------------------------------------------------------------------
+ * Write the tables and the indexes, and close the file
+ *
+ * Returns 0 if the file has been written, -1 otherwise
+ */
+int recordClose(t_recordWriter* w);
+
+
+/* ------------------------------------------------------------------
+ * Open a record file (mapped in memory)
+ * The header, the sections and the columns are checked (arenas, walls, moves and
+ * names inside their sections), so that the reader can then trust the file
+ *
+ * Returns the reader, NULL if the file cannot be read or is invalid
+ */
+t_recordReader* recordOpen(const char* fileName);
+
+
+/* -------------------
+ * Close a record file
+ */
+void recordFree(t_recordReader* r);
+
+
+/* ----------------------------------------------
+ * Move k of the game g (read in the mapped file)
+ */
+static inline t_move recordGameMove(const t_recordReader* r, uint32_t g, uint32_t k) {
+	return (r->moves[r->movesOffset[g] + (k >> 2)] >> (2 * (k & 3))) & 3;
+}
+
+
+/* ----------------------
+ * Name of the game g
+ */
+static inline const char* recordGameName(const t_recordReader* r, uint32_t g) {
+	return r->names + r->name[g];
+}
+
+
+/* --------------------------------------------------------------------
+ * Build the starting position of the game g
+ *
+ * Returns the game (to be freed with `freeGame`)
+ */
+t_game* recordGame(const t_recordReader* r, uint32_t g);
+
+
+/* -------------------------------------------------------------------------
+ * Games of a given seed: they are bySeed[first] ... bySeed[first+nb-1]
+ *
+ * Returns nb (0 if there is none)
+ */
+int recordFindSeed(const t_recordReader* r, uint32_t seed, uint32_t* first);
+
+
+/* -------------------------------------------------------------------------
+ * Find a game by its name
+ *
+ * Returns its index, or -1 if there is none
+ */
+long recordFindName(const t_recordReader* r, const char* name);
+
+
+/* ---------------------------------------------------------------------------------
+ * Iterate on the positions of the game g: after `recordIterBegin`, each call to
+ * `recordIterNext` gives the next move, it->pos being the position before it
+ * (the iterator can be reused for several games, it keeps the last arena)
+ */
+void recordIterInit(t_recordIter* it, const t_recordReader* r);
+void recordIterBegin(t_recordIter* it, uint32_t g);
+int recordIterNext(t_recordIter* it, t_move* move);
+void recordIterFree(t_recordIter* it);
+
+
+#endif
@@ -0,0 +1,379 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: nnEval.c
+	Evaluation of a position with a small quantized neural network
+	(value and policy), with incremental update of the first layer
+
+	The first layer is a sum of the weights of the active features (kept in accumulators,
+	updated when a head or a tail moves). The other layers use 8-bit inputs and weights,
+	with AVX2 instructions when they are available (compile with -mavx2)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "clientAPI.h"
+#include "nnEval.h"
+
+
+#define NN_MAGIC "SNNU"
+#define NN_VERSION 1
+
+
+
+/* index of the feature (plane, cell) */
+static int feature(const t_network* net, const t_game* game, int plane, int cell) {
+	int x = cell % game->sizeX, y = cell / game->sizeX;
+	return plane * net->sizeX * net->sizeY + y * net->sizeX + x;
+}
+
+/* index of the feature of the growth phase of a snake (ours or not) */
+static int phaseFeature(const t_network* net, int ours, int nbMoves) {
+	return NN_NB_PLANES * net->sizeX * net->sizeY + (ours ? 0 : GROWTH_PERIOD) + nbMoves % GROWTH_PERIOD;
+}
+
+
+/* add/subtract the weights of the feature f to the accumulator */
+static void addFeature(const t_network* net, int16_t* acc, int f) {
+	const int16_t* w = net->w1 + (size_t) f * net->hidden;
+#ifdef __AVX2__
+	for (int i = 0; i < net->hidden; i += 16) {
+		__m256i a = _mm256_load_si256((const __m256i*) (acc + i));
+		__m256i b = _mm256_load_si256((const __m256i*) (w + i));
+		_mm256_store_si256((__m256i*) (acc + i), _mm256_add_epi16(a, b));
+	}
+#else
+	for (int i = 0; i < net->hidden; i++)
+		acc[i] += w[i];
+#endif
+}
+
+static void subFeature(const t_network* net, int16_t* acc, int f) {
+	const int16_t* w = net->w1 + (size_t) f * net->hidden;
+#ifdef __AVX2__
+	for (int i = 0; i < net->hidden; i += 16) {
+		__m256i a = _mm256_load_si256((const __m256i*) (acc + i));
+		__m256i b = _mm256_load_si256((const __m256i*) (w + i));
+		_mm256_store_si256((__m256i*) (acc + i), _mm256_sub_epi16(a, b));
+	}
+#else
+	for (int i = 0; i < net->hidden; i++)
+		acc[i] -= w[i];
+#endif
+}
+
+
+/* clipped ReLU of n int16 values, to [0,127] */
+static void clip(const int16_t* in, uint8_t* out, int n) {
+#ifdef __AVX2__
+	const __m256i zero = _mm256_setzero_si256();
+	for (int i = 0; i < n; i += 32) {
+		__m256i a = _mm256_load_si256((const __m256i*) (in + i));
+		__m256i b = _mm256_load_si256((const __m256i*) (in + i + 16));
+		/* packs saturates to [-128,127], then max with 0 (the lanes are interleaved by packs) */
+		__m256i p = _mm256_max_epi8(_mm256_packs_epi16(a, b), zero);
+		_mm256_store_si256((__m256i*) (out + i), _mm256_permute4x64_epi64(p, 0xD8));
+	}
+#else
+	for (int i = 0; i < n; i++)
+		out[i] = in[i] < 0 ? 0 : in[i] > 127 ? 127 : in[i];
+#endif
+}
+
+
+/* dot product of n unsigned 8-bit inputs (<=127) and signed 8-bit weights (n multiple of 32) */
+static int32_t dot(const uint8_t* in, const int8_t* w, int n) {
+#ifdef __AVX2__
+	const __m256i ones = _mm256_set1_epi16(1);
+	__m256i sum = _mm256_setzero_si256();
+	for (int i = 0; i < n; i += 32) {
+		__m256i a = _mm256_load_si256((const __m256i*) (in + i));
+		__m256i b = _mm256_loadu_si256((const __m256i*) (w + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+	}
+	__m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+	return _mm_cvtsi128_si32(s);
+#else
+	int32_t sum = 0;
+	for (int i = 0; i < n; i++)
+		sum += in[i] * w[i];
+	return sum;
+#endif
+}
+
+
+/* allocate memory aligned for the AVX2 instructions (NULL if not possible) */
+static void* alignedAlloc(size_t size) {
+	void* p;
+	return posix_memalign(&p, 32, size) ? NULL : p;
+}
+
+
+/* allocate the weights of a network (the sizes may come from a file)
+ * Returns NULL if the sizes are invalid or if the memory cannot be allocated */
+static t_network* allocNetwork(uint32_t sizeX, uint32_t sizeY, uint32_t hidden, uint32_t hidden2) {
+	if (hidden == 0 || hidden > NN_MAX_HIDDEN || hidden % 32 || hidden2 == 0 || hidden2 > NN_MAX_HIDDEN || hidden2 % 32
+		|| sizeX == 0 || sizeX > NN_MAX_SIZE || sizeY == 0 || sizeY > NN_MAX_SIZE)
+		return NULL;
+	t_network* net = calloc(1, sizeof(t_network));
+	if (!net)
+		return NULL;
+	net->sizeX = sizeX;
+	net->sizeY = sizeY;
+	net->hidden = hidden;
+	net->hidden2 = hidden2;
+	size_t nbFeatures = (size_t) NN_NB_PLANES * sizeX * sizeY + 2 * GROWTH_PERIOD;
+	net->nbFeatures = nbFeatures;
+	net->w1 = alignedAlloc(nbFeatures * hidden * sizeof(int16_t));
+	net->b1 = alignedAlloc(hidden * sizeof(int16_t));
+	net->w2 = alignedAlloc((size_t) hidden2 * 2 * hidden);
+	net->b2 = alignedAlloc(hidden2 * sizeof(int32_t));
+	net->w3 = alignedAlloc(5 * hidden2);
+	net->b3 = alignedAlloc(32);
+	if (!net->w1 || !net->b1 || !net->w2 || !net->b2 || !net->w3 || !net->b3) {
+		freeNetwork(net);
+		return NULL;
+	}
+	return net;
+}
+
+
+
+/* ------------------------------------------------------------------------
+ * Load a network from a file
+ * Format (little endian): "SNNU", version (uint32, 1), sizeX, sizeY, hidden, hidden2 (uint32),
+ * scale (float), then w1, b1 (int16), w2 (int8), b2 (int32), w3 (int8), b3 (int32)
+ *
+ * Returns the network (to be freed with `freeNetwork`), or NULL if the file cannot be read
+ */
+t_network* loadNetwork(const char* fileName) {
+	FILE* f = fopen(fileName, "rb");
+	if (!f) {
+		dispDebug(__FUNCTION__, 1, "Cannot open %s", fileName);
+		return NULL;
+	}
+
+	char magic[4];
+	uint32_t header[5];
+	float scale;
+	t_network* net = NULL;
+	if (fread(magic, 4, 1, f) == 1 && memcmp(magic, NN_MAGIC, 4) == 0
+		&& fread(header, sizeof(header), 1, f) == 1 && header[0] == NN_VERSION
+		&& fread(&scale, sizeof(float), 1, f) == 1)
+		net = allocNetwork(header[1], header[2], header[3], header[4]);
+
+	if (net) {
+		net->scale = scale;
+		int h = net->hidden, h2 = net->hidden2;
+		if (fread(net->w1, sizeof(int16_t), (size_t) net->nbFeatures * h, f) != (size_t) net->nbFeatures * h
+			|| fread(net->b1, sizeof(int16_t), h, f) != (size_t) h
+			|| fread(net->w2, 1, (size_t) h2 * 2 * h, f) != (size_t) h2 * 2 * h
+			|| fread(net->b2, sizeof(int32_t), h2, f) != (size_t) h2
+			|| fread(net->w3, 1, 5 * h2, f) != (size_t) 5 * h2
+			|| fread(net->b3, sizeof(int32_t), 5, f) != 5) {
+			freeNetwork(net);
+			net = NULL;
+		}
+	}
+	fclose(f);
+
+	if (!net)
+		dispDebug(__FUNCTION__, 1, "Invalid network file %s", fileName);
+	return net;
+}
+
+
+/* ------------------------------------------------
+ * Save a network in a file (same format as `loadNetwork`)
+ *
+ * Returns 0 if the network is saved, -1 otherwise
+ */
+int saveNetwork(const t_network* net, const char* fileName) {
+	FILE* f = fopen(fileName, "wb");
+	if (!f)
+		return -1;
+	uint32_t header[5] = {NN_VERSION, net->sizeX, net->sizeY, net->hidden, net->hidden2};
+	int h = net->hidden, h2 = net->hidden2;
+	int ok = fwrite(NN_MAGIC, 4, 1, f) == 1
+		&& fwrite(header, sizeof(header), 1, f) == 1
+		&& fwrite(&net->scale, sizeof(float), 1, f) == 1
+		&& fwrite(net->w1, sizeof(int16_t), (size_t) net->nbFeatures * h, f) == (size_t) net->nbFeatures * h
+		&& fwrite(net->b1, sizeof(int16_t), h, f) == (size_t) h
+		&& fwrite(net->w2, 1, (size_t) h2 * 2 * h, f) == (size_t) h2 * 2 * h
+		&& fwrite(net->b2, sizeof(int32_t), h2, f) == (size_t) h2
+		&& fwrite(net->w3, 1, 5 * h2, f) == (size_t) 5 * h2
+		&& fwrite(net->b3, sizeof(int32_t), 5, f) == 5;
+	return fclose(f) == 0 && ok ? 0 : -1;
+}
+
+
+/* --------------------------------------------------------
+ * Create a network with given sizes, and random weights (used to test, or before training)
+ */
+t_network* newNetwork(int sizeX, int sizeY, int hidden, int hidden2, unsigned int seed) {
+	t_network* net = sizeX > 0 && sizeY > 0 && hidden > 0 && hidden2 > 0 ? allocNetwork(sizeX, sizeY, hidden, hidden2) : NULL;
+	if (!net)
+		dispError(__FUNCTION__, "Cannot create the network (hidden and hidden2 must be multiples of 32 up to %d, sizeX and sizeY up to %d)",
+			NN_MAX_HIDDEN, NN_MAX_SIZE);
+	srand(seed);
+	for (size_t i = 0; i < (size_t) net->nbFeatures * hidden; i++)
+		net->w1[i] = rand() % 33 - 16;
+	for (int i = 0; i < hidden; i++)
+		net->b1[i] = rand() % 64;
+	for (int i = 0; i < hidden2 * 2 * hidden; i++)
+		net->w2[i] = rand() % 17 - 8;
+	for (int i = 0; i < hidden2; i++)
+		net->b2[i] = rand() % 256;
+	for (int i = 0; i < 5 * hidden2; i++)
+		net->w3[i] = rand() % 65 - 32;
+	for (int i = 0; i < 5; i++)
+		net->b3[i] = 0;
+	net->scale = 1.0f / (127 * 64);
+	return net;
+}
+
+
+/* --------------
+ * Free a network
+ */
+void freeNetwork(t_network* net) {
+	if (!net)
+		return;
+	free(net->w1);
+	free(net->b1);
+	free(net->w2);
+	free(net->b2);
+	free(net->w3);
+	free(net->b3);
+	free(net);
+}
+
+
+/* ---------------------------------------------------
+ * Compute the accumulators of the game from scratch
+ */
+void nnRefresh(const t_network* net, const t_game* game, t_nnAcc* acc) {
+	if (game->sizeX > net->sizeX || game->sizeY > net->sizeY)
+		dispError(__FUNCTION__, "The arena (%dx%d) is too large for the network (%dx%d)", game->sizeX, game->sizeY, net->sizeX, net->sizeY);
+
+	for (int q = 0; q < 2; q++) {
+		int16_t* a = acc->acc[q];
+		memcpy(a, net->b1, net->hidden * sizeof(int16_t));
+
+		/* walls (and borders) */
+		for (int c = 0; c < game->nbCells; c++)
+			for (int d = 0; d < 4; d++)
+				if (game->next[4 * c + d] < 0)
+					addFeature(net, a, feature(net, game, NN_WALL + d, c));
+
+		/* snakes */
+		for (int p = 0; p < 2; p++) {
+			int ours = p == q;
+			for (int k = 0; k < game->snake[p].length; k++)
+				addFeature(net, a, feature(net, game, ours ? NN_OUR_BODY : NN_THEIR_BODY, snakeCell(game, p, k)));
+			addFeature(net, a, feature(net, game, ours ? NN_OUR_HEAD : NN_THEIR_HEAD, snakeHead(game, p)));
+			addFeature(net, a, phaseFeature(net, ours, game->snake[p].nbMoves));
+		}
+	}
+}
+
+
+/* ------------------------------------------------------------------------
+ * Compute the accumulators of a child position from the ones of its parent
+ * (only the features of the head, the tail and the growth phase are updated)
+ *
+ * Parameters:
+ * - net: the network
+ * - game: the game, after the move
+ * - undo: the information given by `playGameMove`
+ * - parent: the accumulators before the move
+ * - child: filled with the accumulators after the move (can be the same as parent)
+ */
+void nnPlay(const t_network* net, const t_game* game, const t_undo* undo, const t_nnAcc* parent, t_nnAcc* child) {
+	int p = undo->player;
+	int newHead = snakeHead(game, p), oldHead = snakeCell(game, p, 1);
+	int nbMoves = game->snake[p].nbMoves;
+
+	if (child != parent)
+		for (int q = 0; q < 2; q++)
+			memcpy(child->acc[q], parent->acc[q], net->hidden * sizeof(int16_t));
+
+	for (int q = 0; q < 2; q++) {
+		int16_t* a = child->acc[q];
+		int ours = p == q;
+		addFeature(net, a, feature(net, game, ours ? NN_OUR_BODY : NN_THEIR_BODY, newHead));
+		addFeature(net, a, feature(net, game, ours ? NN_OUR_HEAD : NN_THEIR_HEAD, newHead));
+		subFeature(net, a, feature(net, game, ours ? NN_OUR_HEAD : NN_THEIR_HEAD, oldHead));
+		if (undo->freedTail >= 0)
+			subFeature(net, a, feature(net, game, ours ? NN_OUR_BODY : NN_THEIR_BODY, undo->freedTail));
+		subFeature(net, a, phaseFeature(net, ours, nbMoves - 1));
+		addFeature(net, a, phaseFeature(net, ours, nbMoves));
+	}
+}
+
+
+/* -----------------------------------------------------------------
+ * Evaluate a position
+ *
+ * Parameters:
+ * - net: the network
+ * - acc: the accumulators of the position
+ * - player: the player that has to play
+ * - policy: (can be NULL) filled with the logits of the 4 moves
+ *
+ * Returns the value of the position for the player
+ */
+float nnEvaluate(const t_network* net, const t_nnAcc* acc, int player, float policy[4]) {
+	uint8_t in[2 * NN_MAX_HIDDEN] __attribute__((aligned(32)));
+	uint8_t h2[NN_MAX_HIDDEN] __attribute__((aligned(32)));
+	int h = net->hidden;
+
+	/* first layer: our perspective, then the opponent's one */
+	clip(acc->acc[player], in, h);
+	clip(acc->acc[1 - player], in + h, h);
+
+	/* second layer */
+	for (int j = 0; j < net->hidden2; j++) {
+		int32_t s = (net->b2[j] + dot(in, net->w2 + (size_t) j * 2 * h, 2 * h)) >> NN_SHIFT;
+		h2[j] = s < 0 ? 0 : s > 127 ? 127 : s;
+	}
+
+	/* outputs */
+	float value = (net->b3[0] + dot(h2, net->w3, net->hidden2)) * net->scale;
+	if (policy)
+		for (int m = 0; m < 4; m++)
+			policy[m] = (net->b3[1 + m] + dot(h2, net->w3 + (1 + m) * net->hidden2, net->hidden2)) * net->scale;
+	return value;
+}
+
+
+/* -----------------------------------------------------------------
+ * Evaluate a batch of n positions (same as `nnEvaluate` for each of them)
+ * policies can be NULL
+ */
+void nnEvaluateBatch(const t_network* net, const t_nnAcc* const* accs, const int* players, int n, float* values, float (*policies)[4]) {
+	for (int i = 0; i < n; i++)
+		values[i] = nnEvaluate(net, accs[i], players[i], policies ? policies[i] : NULL);
+}
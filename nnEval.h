@@ -0,0 +1,142 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: nnEval.h
+	Evaluation of a position with a small quantized neural network
+	(value and policy), with incremental update of the first layer
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_NN_EVAL__
+#define __SNAKE_NN_EVAL__
+#include <stdint.h>
+#include "snakeGame.h"
+
+
+#define NN_MAX_HIDDEN 512		/* maximal size of the hidden layers */
+#define NN_MAX_SIZE 1000		/* maximal sizeX and sizeY of a network */
+#define NN_SHIFT 6				/* right shift applied to the output of the second layer */
+
+/* Planes of input features (for each cell of the arena, from the point of view of a player) */
+enum {
+	NN_WALL = 0,		/* 4 planes: wall in direction NORTH, EAST, SOUTH, WEST of the cell */
+	NN_OUR_BODY = 4,	/* cell occupied by our snake (head included) */
+	NN_THEIR_BODY,		/* cell occupied by the opponent */
+	NN_OUR_HEAD,		/* head of our snake */
+	NN_THEIR_HEAD,		/* head of the opponent */
+	NN_NB_PLANES
+};
+/* then 2*GROWTH_PERIOD features for the growth phase (number of moves modulo 10) of our snake and of the opponent */
+
+
+/* The network (weights of the layers)
+ * input features -> hidden (int16, two perspectives) -> clipped ReLU -> hidden2 (int8) -> clipped ReLU -> 1 value + 4 policy */
+typedef struct {
+	int sizeX, sizeY;		/* the network accepts arenas up to this size */
+	int nbFeatures;
+	int hidden, hidden2;	/* sizes of the hidden layers (multiples of 32) */
+	float scale;			/* scale of the outputs */
+	int16_t* w1;			/* w1[f*hidden+i]: weight of the feature f for the neuron i */
+	int16_t* b1;
+	int8_t* w2;				/* w2[j*2*hidden+i] */
+	int32_t* b2;
+	int8_t* w3;				/* w3[k*hidden2+j], k=0 for the value, 1..4 for the policy of each move */
+	int32_t* b3;
+} t_network;
+
+
+/* Accumulators of the first layer, from the point of view of each player */
+typedef struct {
+	int16_t acc[2][NN_MAX_HIDDEN] __attribute__((aligned(32)));
+} t_nnAcc;
+
+
+
+/* ------------------------------------------------------------------------
+ * Load a network from a file
+ * Format (little endian): "SNNU", version (uint32, 1), sizeX, sizeY, hidden, hidden2 (uint32),
+ * scale (float), then w1, b1 (int16), w2 (int8), b2 (int32), w3 (int8), b3 (int32)
+ *
+ * Returns the network (to be freed with `freeNetwork`), or NULL if the file cannot be read
+ */
+t_network* loadNetwork(const char* fileName);
+
+
+/* ------------------------------------------------
+ * Save a network in a file (same format as `loadNetwork`)
+ *
+ * Returns 0 if the network is saved, -1 otherwise
+ */
+int saveNetwork(const t_network* net, const char* fileName);
+
+
+/* --------------------------------------------------------
+ * Create a network with given sizes, and random weights (used to test, or before training)
+ */
+t_network* newNetwork(int sizeX, int sizeY, int hidden, int hidden2, unsigned int seed);
+
+
+/* --------------
+ * Free a network
+ */
+void freeNetwork(t_network* net);
+
+
+/* ---------------------------------------------------
+ * Compute the accumulators of the game from scratch
+ */
+void nnRefresh(const t_network* net, const t_game* game, t_nnAcc* acc);
+
+
+/* ------------------------------------------------------------------------
+ * Compute the accumulators of a child position from the ones of its parent
+ * (only the features of the head, the tail and the growth phase are updated)
+ *
+ * Parameters:
+ * - net: the network
+ * - game: the game, after the move
+ * - undo: the information given by `playGameMove`
+ * - parent: the accumulators before the move
+ * - child: filled with the accumulators after the move (can be the same as parent)
+ */
+void nnPlay(const t_network* net, const t_game* game, const t_undo* undo, const t_nnAcc* parent, t_nnAcc* child);
+
+
+/* -----------------------------------------------------------------
+ * Evaluate a position
+ *
+ * Parameters:
+ * - net: the network
+ * - acc: the accumulators of the position
+ * - player: the player that has to play
+ * - policy: (can be NULL) filled with the logits of the 4 moves
+ *
+ * Returns the value of the position for the player
+ */
+float nnEvaluate(const t_network* net, const t_nnAcc* acc, int player, float policy[4]);
+
+
+/* -----------------------------------------------------------------
+ * Evaluate a batch of n positions (same as `nnEvaluate` for each of them)
+ * policies can be NULL
+ */
+void nnEvaluateBatch(const t_network* net, const t_nnAcc* const* accs, const int* players, int n, float* values, float (*policies)[4]);
+
+
+#endif
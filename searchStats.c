@@ -0,0 +1,221 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: searchStats.c
+	Statistics of the search, turn by turn (nodes, depth, transposition table,
+	cutoffs, evaluation time, think time and time spent waiting for the server)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "clientAPI.h"
+#include "searchStats.h"
+
+
+__thread t_counters statCounters;
+
+/* statistics of the current game */
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static t_counters turnCounters;		/* counters flushed by the threads during the turn */
+static char gameName[51];
+static double origin;				/* beginning of the game */
+static double budget;				/* time budget of a turn */
+static double turnStart;
+static int inTurn = 0;
+static int nbMoves = 0;				/* number of moves played in the game (both players) */
+static t_turnStats* turns = NULL;
+static int nbTurns = 0, sizeTurns = 0;
+static char* traceDir = NULL;
+
+
+/* ratio a/b (0 if b is 0) */
+static double ratio(double a, double b) {
+	return b ? a / b : 0;
+}
+
+
+/* add the counters b to a */
+static void addCounters(t_counters* a, const t_counters* b) {
+	a->nodes += b->nodes;
+	a->ttProbes += b->ttProbes;
+	a->ttHits += b->ttHits;
+	a->ttStores += b->ttStores;
+	a->ttOverwrites += b->ttOverwrites;
+	a->cutoffs += b->cutoffs;
+	a->firstCutoffs += b->firstCutoffs;
+	a->evals += b->evals;
+	a->evalTime += b->evalTime;
+	if (b->depth > a->depth)
+		a->depth = b->depth;
+}
+
+
+/* --------------------------------------------------------------------
+ * Add the counters of the calling thread to the ones of the turn, and reset them
+ * (to be called by the threads of a parallel search, before the move is sent)
+ */
+void statsFlush() {
+	pthread_mutex_lock(&mutex);
+	addCounters(&turnCounters, &statCounters);
+	pthread_mutex_unlock(&mutex);
+	memset(&statCounters, 0, sizeof(t_counters));
+}
+
+
+/* --------------------------------------------------------------------
+ * Set the time budget of a turn (in seconds, 0 if unknown)
+ * By default, it is the timeout given in the gameType of `waitForSnakeGame`
+ * (to be called after `waitForSnakeGame` to change it)
+ */
+void statsSetBudget(double b) {
+	budget = b;
+}
+
+
+/* --------------------------------------------------------------------
+ * Dump each game in a Chrome trace file <dir>/<gameName>.json (NULL to stop)
+ */
+void statsSetTrace(const char* dir) {
+	free(traceDir);
+	traceDir = dir ? strdup(dir) : NULL;
+}
+
+
+/* ---------------------------------------------------------------------
+ * Statistics of the last turn, and of all the turns of the current (or last) game
+ *
+ * Returns NULL if there is no turn yet
+ */
+const t_turnStats* statsLastTurn() {
+	return nbTurns ? &turns[nbTurns - 1] : NULL;
+}
+
+const t_turnStats* statsGameTurns(int* nb) {
+	*nb = nbTurns;
+	return nbTurns ? turns : NULL;
+}
+
+
+/* -------------------------------------------------
+ * Write one line with the statistics of a turn
+ */
+void statsPrintTurn(FILE* f, const t_turnStats* t) {
+	const t_counters* c = &t->c;
+	fprintf(f, "turn %d: %ld nodes (%.0f n/s), depth %d, TT hits %.1f%% overwrites %.1f%%, "
+		"first-move cutoffs %.1f%%, eval %.1f%%, think %.3fs, send %.3fs, get %.3fs, remaining %.3fs\n",
+		t->turn, c->nodes, ratio(c->nodes, t->think), c->depth, 100 * ratio(c->ttHits, c->ttProbes),
+		100 * ratio(c->ttOverwrites, c->ttStores), 100 * ratio(c->firstCutoffs, c->cutoffs),
+		100 * ratio(c->evalTime, t->think), t->think, t->sendTime, t->getTime, t->remaining);
+}
+
+
+/* ---------------------------------------------------------------------------------
+ * Functions called by snakeAPI.c compiled with -DSNAKE_SEARCH_STATS (beginning and end of the games and of the turns,
+ * time spent in `sendCGSMove` and `getCGSMove`)
+ */
+void statsBeginGame(const char* name, const char* gameType) {
+	snprintf(gameName, sizeof(gameName), "%s", name);
+	const char* timeout = gameType ? strstr(gameType, "timeout=") : NULL;
+	budget = timeout ? atof(timeout + 8) : 0;
+	origin = statTime();
+	nbMoves = nbTurns = 0;
+	inTurn = 0;
+}
+
+
+void statsBeginTurn() {
+	memset(&statCounters, 0, sizeof(t_counters));
+	pthread_mutex_lock(&mutex);
+	memset(&turnCounters, 0, sizeof(t_counters));
+	pthread_mutex_unlock(&mutex);
+	turnStart = statTime();
+	inTurn = 1;
+}
+
+
+void statsEndTurn() {
+	if (!inTurn)
+		return;
+	double t = statTime();
+	statsFlush();
+	if (nbTurns == sizeTurns) {
+		sizeTurns = sizeTurns ? 2 * sizeTurns : 256;
+		turns = realloc(turns, sizeTurns * sizeof(t_turnStats));
+		if (!turns)
+			dispError(__FUNCTION__, "Cannot allocate the statistics");
+	}
+	t_turnStats* s = &turns[nbTurns++];
+	s->turn = nbMoves;
+	s->c = turnCounters;
+	s->start = turnStart - origin;
+	s->think = t - turnStart;
+	s->sendTime = s->getTime = 0;
+	s->remaining = budget > 0 ? budget - s->think : 0;
+	inTurn = 0;
+	dispDebug(__FUNCTION__, 1, "turn %d: %ld nodes (%.0f n/s), depth %d, think %.3fs", s->turn, s->c.nodes,
+		ratio(s->c.nodes, s->think), s->c.depth, s->think);
+}
+
+
+void statsWire(int send, double time) {
+	nbMoves++;
+	if (!nbTurns)
+		return;
+	if (send)
+		turns[nbTurns - 1].sendTime += time;
+	else
+		turns[nbTurns - 1].getTime += time;
+}
+
+
+void statsEndGame() {
+	inTurn = 0;
+	if (!traceDir)
+		return;
+	char fileName[1024];
+	snprintf(fileName, sizeof(fileName), "%s/%s.json", traceDir, gameName);
+	FILE* f = fopen(fileName, "w");
+	if (!f) {
+		dispDebug(__FUNCTION__, 0, "Cannot write the trace %s", fileName);
+		return;
+	}
+	/* times in microseconds; the search on thread 1, the server on thread 2 */
+	fprintf(f, "{\"traceEvents\":[\n");
+	for (int i = 0; i < nbTurns; i++) {
+		const t_turnStats* t = &turns[i];
+		const t_counters* c = &t->c;
+		double ts = 1e6 * t->start;
+		fprintf(f, "{\"name\":\"think\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.0f,\"dur\":%.0f,\"args\":{"
+			"\"turn\":%d,\"nodes\":%ld,\"nps\":%.0f,\"depth\":%d,\"ttHitRate\":%.4f,\"ttOverwriteRate\":%.4f,"
+			"\"firstCutoffRate\":%.4f,\"evals\":%ld,\"evalShare\":%.4f,\"remaining\":%.6f}},\n",
+			ts, 1e6 * t->think, t->turn, c->nodes, ratio(c->nodes, t->think), c->depth,
+			ratio(c->ttHits, c->ttProbes), ratio(c->ttOverwrites, c->ttStores), ratio(c->firstCutoffs, c->cutoffs),
+			c->evals, ratio(c->evalTime, t->think), t->remaining);
+		fprintf(f, "{\"name\":\"sendCGSMove\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.0f,\"dur\":%.0f},\n",
+			ts + 1e6 * t->think, 1e6 * t->sendTime);
+		fprintf(f, "{\"name\":\"getCGSMove\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.0f,\"dur\":%.0f},\n",
+			ts + 1e6 * (t->think + t->sendTime), 1e6 * t->getTime);
+		fprintf(f, "{\"name\":\"nodes/s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.0f,\"args\":{\"nps\":%.0f}}%s\n",
+			ts, ratio(c->nodes, t->think), i + 1 < nbTurns ? "," : "");
+	}
+	fprintf(f, "],\n\"otherData\":{\"game\":\"%s\"}}\n", gameName);
+	fclose(f);
+}
@@ -0,0 +1,138 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: searchStats.h
+	Statistics of the search, turn by turn (nodes, depth, transposition table,
+	cutoffs, evaluation time, think time and time spent waiting for the server)
+
+	The statistics are only compiled with -DSNAKE_SEARCH_STATS (then searchStats.c must be linked):
+	the search increments the counters with the STAT_xxx macros (thread-local; they do nothing
+	otherwise, so the modules do not depend on searchStats.c), and snakeAPI.c closes a turn when
+	the move is sent. The turns of a game can be dumped in a Chrome trace file (chrome://tracing)
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_SEARCH_STATS__
+#define __SNAKE_SEARCH_STATS__
+#include <stdio.h>
+#include <time.h>
+
+
+/* Counters incremented by the search */
+typedef struct {
+	long nodes;
+	long ttProbes, ttHits;			/* probes of the transposition table, and hits */
+	long ttStores, ttOverwrites;	/* stores, and stores that replace another position */
+	long cutoffs, firstCutoffs;		/* beta-cutoffs, and the ones produced by the first move */
+	long evals;
+	double evalTime;				/* time spent in the evaluation (in seconds) */
+	int depth;						/* maximal depth completed */
+} t_counters;
+
+
+/* Statistics of a turn (from the end of `getMove` to the call of `sendMove`) */
+typedef struct {
+	int turn;				/* number of moves already played in the game (both players) */
+	t_counters c;
+	double start;			/* beginning of the turn (in seconds, from the beginning of the game) */
+	double think;			/* time between the end of `getMove` and the call of `sendMove` */
+	double sendTime;		/* time spent in `sendCGSMove` */
+	double getTime;			/* time spent in the following `getCGSMove` (it includes the opponent's turn) */
+	double remaining;		/* remaining time budget of the turn (negative if exceeded, 0 if unknown) */
+} t_turnStats;
+
+
+extern __thread t_counters statCounters;
+
+#ifdef SNAKE_SEARCH_STATS
+#define STAT_NODE() (statCounters.nodes++)
+#define STAT_TT_PROBE(hit) (statCounters.ttProbes++, statCounters.ttHits += (hit) != 0)
+#define STAT_TT_STORE(overwrite) (statCounters.ttStores++, statCounters.ttOverwrites += (overwrite) != 0)
+#define STAT_CUTOFF(first) (statCounters.cutoffs++, statCounters.firstCutoffs += (first) != 0)
+#define STAT_EVAL(time) (statCounters.evals++, statCounters.evalTime += (time))
+#define STAT_DEPTH(d) ((d) > statCounters.depth ? statCounters.depth = (d) : 0)
+#define STAT_CLOCK() statTime()
+#else
+#define STAT_NODE() ((void) 0)
+#define STAT_TT_PROBE(hit) ((void) 0)
+#define STAT_TT_STORE(overwrite) ((void) 0)
+#define STAT_CUTOFF(first) ((void) 0)
+#define STAT_EVAL(time) ((void) sizeof(time))
+#define STAT_DEPTH(d) ((void) 0)
+#define STAT_CLOCK() 0.0
+#endif
+
+
+/* current time (in seconds), used to measure the evaluation time (with STAT_CLOCK) */
+static inline double statTime() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+
+
+/* --------------------------------------------------------------------
+ * Add the counters of the calling thread to the ones of the turn, and reset them
+ * (to be called by the threads of a parallel search, before the move is sent)
+ */
+void statsFlush();
+
+
+/* --------------------------------------------------------------------
+ * Set the time budget of a turn (in seconds, 0 if unknown)
+ * By default, it is the timeout given in the gameType of `waitForSnakeGame`
+ * (to be called after `waitForSnakeGame` to change it)
+ */
+void statsSetBudget(double budget);
+
+
+/* --------------------------------------------------------------------
+ * Dump each game in a Chrome trace file <dir>/<gameName>.json (NULL to stop)
+ */
+void statsSetTrace(const char* dir);
+
+
+/* ---------------------------------------------------------------------
+ * Statistics of the last turn, and of all the turns of the current (or last) game
+ *
+ * Returns NULL if there is no turn yet
+ */
+const t_turnStats* statsLastTurn();
+const t_turnStats* statsGameTurns(int* nbTurns);
+
+
+/* -------------------------------------------------
+ * Write one line with the statistics of a turn
+ */
+void statsPrintTurn(FILE* f, const t_turnStats* t);
+
+
+/* ---------------------------------------------------------------------------------
+ * Functions called by snakeAPI.c compiled with -DSNAKE_SEARCH_STATS (beginning and end of the games and of the turns,
+ * time spent in `sendCGSMove` and `getCGSMove`)
+ */
+void statsBeginGame(const char* gameName, const char* gameType);
+void statsBeginTurn();
+void statsEndTurn();
+void statsWire(int send, double time);
+void statsEndGame();
+
+
+#endif
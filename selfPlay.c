@@ -0,0 +1,775 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: selfPlay.c
+	Distributed self-play: a coordinator hands out games between versions of the bot
+	(snakeBot.h) to workers, on any number of machines, that play them locally
+	(snakeGame.h) and send back the results
+
+	The games are numbered: the game g is played on the arena of seed (first seed + g/2),
+	the two games of a pair swap the versions (each version starts once).
+	The protocol is made of text lines:
+	- HELLO name -> CONFIG difficulty sizeX sizeY budget nbVersions, then one line PARAMS v1 v2 ... by version
+	- GET n -> at most n lines JOB id seed version0 version1 (versionP plays for the player P) then END,
+	           or WAIT (no game available now, ask again later) or QUIT (all the games are done)
+	- RESULT id winner nbMoves moves (the moves in hexadecimal, 2 moves by digit), no answer
+	When there is no more game to hand out, a game still running for more than twice the mean
+	duration of a game (from its assignment to its result) is given to another worker
+	(work stealing of the stragglers, the first result is kept), and the games of a lost worker
+	(closed connection, or no result for too long) are handed out again.
+	The results are appended to a file, that is read at start to resume an interrupted run.
+	At the end, the games of the results file can be written in a record file (gameRecord.h).
+
+	Compile with: gcc -O2 selfPlay.c snakeBot.c arenaGen.c snakeGame.c chamber.c endgame.c tablebase.c gameRecord.c clientAPI.c -pthread -lm
+
+	Usage: selfPlay -C [-p port] [-g gameType] [-n games] [-v params]... [-b budget] [-o results] [-r records] [-T timeout] [-s period]
+	       selfPlay -w server [-p port] [-t threads] [-B batch]
+	  -C: coordinator
+	    -g: options of the games ("difficulty=2 seed=123 sizeX=40 sizeY=20"), the seed is the one of the first arena
+	    -n: number of games (1000 by default)
+	    -v: parameter file of a version of the bot (can be repeated, default parameters if none);
+	        the pairs of games go through all the pairs of versions
+	    -b: time budget of each move in seconds (0 by default: fixed depth)
+	    -o: results file (selfPlay.txt by default)
+	    -r: record file, where all the games of the results file are written at the end
+	    -T: a worker that sends no result during this time (in seconds, 300 by default) is considered as lost
+	    -s: period (in seconds) of the progress report (10 by default)
+	  -w: worker, connected to the coordinator on the server given
+	    -t: number of threads (number of cores by default), each one with its own connection
+	    -B: number of games asked at once (4 by default)
+	  -p: port (1235 by default)
+	To test on one machine: selfPlay -C -n 200 & selfPlay -w localhost -t 2 & selfPlay -w localhost -t 2
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "clientAPI.h"
+#include "arenaGen.h"
+#include "snakeBot.h"
+#include "gameRecord.h"
+
+
+#define DEFAULT_PORT 1235
+#define LINE_SIZE 65536			/* maximal size of a line (a RESULT has 1 digit for 2 moves) */
+#define MAX_VERSIONS 16
+#define MAX_COPIES 2			/* maximal number of workers playing the same game (work stealing) */
+#define STEAL_FACTOR 2.0		/* a game is given again after this number of times the mean duration of a game */
+#define WAIT_DELAY 500000		/* delay (in µs) before a worker asks again after WAIT */
+#define MAX_EVENTS 64
+
+
+/* state of a game */
+enum {
+	JOB_TODO,
+	JOB_RUNNING,
+	JOB_DONE
+};
+
+/* A game to play */
+typedef struct {
+	int state;
+	int copies;					/* number of workers playing it */
+	double assigned;			/* time of the last assignment */
+} t_job;
+
+/* A worker connection (seen by the coordinator) */
+typedef struct s_worker {
+	int fd;
+	char name[21];
+	int hello;					/* 1 when HELLO has been received */
+	char in[LINE_SIZE];
+	int nbIn;
+	char* out;					/* data not sent yet */
+	size_t nbOut, sizeOut, sent;
+	int epollOut;				/* 1 if we wait for EPOLLOUT */
+	int* jobs;					/* games given to the worker and not done */
+	int nbJobs, sizeJobs;
+	double lastSeen;			/* time of the last line received */
+	struct s_worker *prev, *next;
+} t_worker;
+
+
+/* the coordinator */
+static int epfd;
+static t_worker* workers = NULL;
+static t_job* jobs;
+static int nbJobs, nbDone = 0, firstTodo = 0;
+static long firstSeed;
+static t_gameOptions gameOpt;
+static double budget = 0;
+static int nbVersions = 0;
+static t_params versions[MAX_VERSIONS];
+static int nbPairs;				/* number of pairs of versions */
+static FILE* results;
+static long nbWorkers = 0, nbLost = 0, nbStolen = 0, nbDuplicates = 0, nbMoves = 0;
+static long wins[MAX_VERSIONS], played[MAX_VERSIONS];
+static double totalDuration = 0;	/* sum of the durations of the games played by only one worker */
+static long nbDurations = 0;
+
+
+/* current time, in seconds */
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+
+/* seed and versions (version[p] plays for the player p) of the game g */
+static void jobGame(int g, long* seed, int version[2]) {
+	*seed = firstSeed + g / 2;
+	/* the k-th pair of versions (a,b), a<b (or (0,0) if there is only one version) */
+	int k = (g / 2) % nbPairs, a = 0, b = nbVersions > 1 ? 1 : 0;
+	while (k-- > 0)
+		if (++b == nbVersions) {
+			a++;
+			b = a + 1;
+		}
+	version[g % 2] = a;
+	version[1 - g % 2] = b;
+}
+
+
+/* queue a formatted line in the output buffer of a worker */
+static void sendLine(t_worker* w, const char* msg, ...) {
+	char tmp[LINE_SIZE];
+	va_list args;
+	va_start(args, msg);
+	int n = vsnprintf(tmp, sizeof(tmp), msg, args);
+	va_end(args);
+	if (n >= (int) sizeof(tmp))
+		n = sizeof(tmp) - 1;
+	size_t size = w->nbOut + n + 1;
+	if (size > w->sizeOut) {
+		w->sizeOut = size < 2 * w->sizeOut ? 2 * w->sizeOut : size;
+		w->out = realloc(w->out, w->sizeOut);
+		if (!w->out)
+			dispError(__FUNCTION__, "Cannot allocate the output buffer");
+	}
+	memcpy(w->out + w->nbOut, tmp, n);
+	w->out[w->nbOut + n] = '\n';
+	w->nbOut += n + 1;
+}
+
+
+/* write what we can of the output buffer (and wait for EPOLLOUT if needed) */
+static void flush(t_worker* w) {
+	while (w->sent < w->nbOut) {
+		ssize_t r = write(w->fd, w->out + w->sent, w->nbOut - w->sent);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				w->sent = w->nbOut;		/* the connection is broken, EPOLLIN will tell it */
+			break;
+		}
+		w->sent += r;
+	}
+	if (w->sent == w->nbOut)
+		w->sent = w->nbOut = 0;
+	int wantOut = w->nbOut > 0;
+	if (wantOut != w->epollOut) {
+		struct epoll_event ev = {.events = EPOLLIN | (wantOut ? EPOLLOUT : 0), .data.ptr = w};
+		epoll_ctl(epfd, EPOLL_CTL_MOD, w->fd, &ev);
+		w->epollOut = wantOut;
+	}
+}
+
+
+/* give the game g to a worker */
+static void assignJob(t_worker* w, int g) {
+	if (w->nbJobs == w->sizeJobs) {
+		w->sizeJobs = w->sizeJobs ? 2 * w->sizeJobs : 8;
+		w->jobs = realloc(w->jobs, w->sizeJobs * sizeof(int));
+		if (!w->jobs)
+			dispError(__FUNCTION__, "Cannot allocate the games of a worker");
+	}
+	w->jobs[w->nbJobs++] = g;
+	jobs[g].state = JOB_RUNNING;
+	jobs[g].copies++;
+	jobs[g].assigned = now();
+	long seed;
+	int version[2];
+	jobGame(g, &seed, version);
+	sendLine(w, "JOB %d %ld %d %d", g, seed, version[0], version[1]);
+}
+
+
+/* remove the game g from the games of a worker (returns 0 if the worker did not have it) */
+static int releaseJob(t_worker* w, int g) {
+	for (int i = 0; i < w->nbJobs; i++)
+		if (w->jobs[i] == g) {
+			w->jobs[i] = w->jobs[--w->nbJobs];
+			if (--jobs[g].copies == 0 && jobs[g].state == JOB_RUNNING) {
+				jobs[g].state = JOB_TODO;
+				if (g < firstTodo)
+					firstTodo = g;
+			}
+			return 1;
+		}
+	return 0;
+}
+
+
+/* answer a GET: the games not given yet, otherwise the oldest running games of the other workers
+ * that are late (running for more than STEAL_FACTOR times the mean duration) */
+static void getJobs(t_worker* w, int n) {
+	int nb = 0;
+	while (nb < n && firstTodo < nbJobs) {
+		if (jobs[firstTodo].state == JOB_TODO) {
+			assignJob(w, firstTodo);
+			nb++;
+		}
+		firstTodo++;
+	}
+	double late = now() - STEAL_FACTOR * totalDuration / (nbDurations ? nbDurations : 1);
+	while (nb < n && nbDurations > 0) {
+		int best = -1;
+		for (t_worker* o = workers; o; o = o->next) {
+			if (o == w)
+				continue;
+			for (int i = 0; i < o->nbJobs; i++) {
+				int g = o->jobs[i];
+				if (jobs[g].state == JOB_RUNNING && jobs[g].copies < MAX_COPIES && jobs[g].assigned < late
+					&& (best < 0 || jobs[g].assigned < jobs[best].assigned)) {
+					int mine = 0;
+					for (int j = 0; j < w->nbJobs; j++)
+						mine |= w->jobs[j] == g;
+					if (!mine)
+						best = g;
+				}
+			}
+		}
+		if (best < 0)
+			break;
+		dispDebug(__FUNCTION__, 2, "Game %d given again to %s", best, w->name);
+		assignJob(w, best);
+		nbStolen++;
+		nb++;
+	}
+	if (nb > 0)
+		sendLine(w, "END");
+	else
+		sendLine(w, nbDone == nbJobs ? "QUIT" : "WAIT");
+}
+
+
+/* record the result of a game (the first one received) */
+static void recordResult(int g, int winner, int turns, const char* moves) {
+	if (jobs[g].state == JOB_DONE) {
+		nbDuplicates++;
+		return;
+	}
+	jobs[g].state = JOB_DONE;
+	nbDone++;
+	nbMoves += turns;
+	long seed;
+	int version[2];
+	jobGame(g, &seed, version);
+	wins[version[winner]]++;
+	played[version[0]]++;
+	played[version[1]]++;
+	if (results) {
+		fprintf(results, "%d %ld %d %d %d %d %s\n", g, seed, version[0], version[1], winner, turns, moves);
+		fflush(results);
+	}
+}
+
+
+/* close a worker connection, its games are given to the other workers */
+static void closeWorker(t_worker* w) {
+	if (w->nbJobs > 0) {
+		dispDebug(__FUNCTION__, 1, "Worker %s lost (%d games to play again)", w->name, w->nbJobs);
+		nbLost++;
+	}
+	while (w->nbJobs > 0)
+		releaseJob(w, w->jobs[0]);
+	if (w->prev)
+		w->prev->next = w->next;
+	else
+		workers = w->next;
+	if (w->next)
+		w->next->prev = w->prev;
+	epoll_ctl(epfd, EPOLL_CTL_DEL, w->fd, NULL);
+	close(w->fd);
+	free(w->out);
+	free(w->jobs);
+	free(w);
+	nbWorkers--;
+}
+
+
+/* execute a line sent by a worker (returns -1 if the worker must be closed) */
+static int command(t_worker* w, char* cmd) {
+	dispDebug(__FUNCTION__, 3, "Receive '%s' from %s", cmd, w->name);
+	char* arg = strchr(cmd, ' ');
+	if (arg)
+		*arg++ = 0;
+	else
+		arg = cmd + strlen(cmd);
+
+	if (strcmp(cmd, "HELLO") == 0) {
+		snprintf(w->name, sizeof(w->name), "%s", arg);
+		w->hello = 1;
+		sendLine(w, "CONFIG %d %d %d %.17g %d", gameOpt.difficulty, gameOpt.sizeX, gameOpt.sizeY, budget, nbVersions);
+		for (int v = 0; v < nbVersions; v++) {
+			char line[LINE_SIZE];
+			int n = snprintf(line, sizeof(line), "PARAMS");
+			for (int i = 0; i < NB_PARAMS; i++)
+				n += snprintf(line + n, sizeof(line) - n, " %.17g", versions[v].v[i]);
+			sendLine(w, "%s", line);
+		}
+	}
+	else if (!w->hello)
+		return -1;
+	else if (strcmp(cmd, "GET") == 0)
+		getJobs(w, atoi(arg) > 0 ? atoi(arg) : 1);
+	else if (strcmp(cmd, "RESULT") == 0) {
+		int g, winner, turns, n;
+		if (sscanf(arg, "%d %d %d %n", &g, &winner, &turns, &n) != 3 || g < 0 || g >= nbJobs || winner < 0 || winner > 1)
+			return -1;
+		/* duration of the game, if only this worker has played it */
+		double duration = now() - jobs[g].assigned;
+		int alone = jobs[g].state == JOB_RUNNING && jobs[g].copies == 1;
+		if (!releaseJob(w, g))
+			return -1;
+		if (alone) {
+			totalDuration += duration;
+			nbDurations++;
+		}
+		recordResult(g, winner, turns, arg + n);
+	}
+	else
+		return -1;
+	return 0;
+}
+
+
+/* accept the new workers */
+static void acceptWorker(int listenfd) {
+	int fd;
+	while ((fd = accept(listenfd, NULL, NULL)) >= 0) {
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		t_worker* w = calloc(1, sizeof(t_worker));
+		if (!w)
+			dispError(__FUNCTION__, "Cannot allocate the worker");
+		w->fd = fd;
+		strcpy(w->name, "?");
+		w->lastSeen = now();
+		struct epoll_event ev = {.events = EPOLLIN, .data.ptr = w};
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) < 0)
+			dispError(__FUNCTION__, "Cannot add the connection to epoll");
+		w->next = workers;
+		if (workers)
+			workers->prev = w;
+		workers = w;
+		nbWorkers++;
+	}
+}
+
+
+/* read the lines of a worker */
+static void readWorker(t_worker* w) {
+	ssize_t r = read(w->fd, w->in + w->nbIn, LINE_SIZE - 1 - w->nbIn);
+	if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+		return;
+	if (r <= 0) {
+		closeWorker(w);
+		return;
+	}
+	w->nbIn += r;
+	w->in[w->nbIn] = 0;
+	w->lastSeen = now();
+	char* line = w->in;
+	char* end;
+	while ((end = strchr(line, '\n'))) {
+		*end = 0;
+		if (command(w, line) < 0) {
+			closeWorker(w);
+			return;
+		}
+		line = end + 1;
+	}
+	w->nbIn -= line - w->in;
+	if (w->nbIn == LINE_SIZE - 1) {
+		closeWorker(w);		/* line too long */
+		return;
+	}
+	memmove(w->in, line, w->nbIn);
+	flush(w);
+}
+
+
+/* read the results file of a previous run (the games already done are not played again) */
+static void readResults(const char* fileName) {
+	FILE* f = fopen(fileName, "r");
+	if (!f)
+		return;
+	char* line = malloc(LINE_SIZE);
+	if (!line)
+		dispError(__FUNCTION__, "Cannot allocate the line");
+	while (fgets(line, LINE_SIZE, f)) {
+		int g, v0, v1, winner, turns;
+		long seed;
+		char* moves = strrchr(line, ' ');
+		if (sscanf(line, "%d %ld %d %d %d %d", &g, &seed, &v0, &v1, &winner, &turns) != 6 || g < 0 || g >= nbJobs || !moves)
+			continue;
+		long s;
+		int version[2];
+		jobGame(g, &s, version);
+		if (s != seed || version[0] != v0 || version[1] != v1 || jobs[g].state == JOB_DONE)
+			continue;
+		moves[strcspn(moves, "\n")] = 0;
+		recordResult(g, winner, turns, moves + 1);		/* results is not opened yet */
+	}
+	free(line);
+	fclose(f);
+}
+
+
+/* write the games of the results file in a record file (seen by the player 0) */
+static void writeRecords(const char* fileName, const char* recordName) {
+	FILE* f = fopen(fileName, "r");
+	if (!f)
+		dispError(__FUNCTION__, "Cannot read the results file %s", fileName);
+	t_recordWriter* rec = recordCreate(recordName);
+	if (!rec)
+		dispError(__FUNCTION__, "Cannot create the record file %s", recordName);
+	char* line = malloc(LINE_SIZE);
+	int* walls = malloc(8 * gameOpt.sizeX * gameOpt.sizeY * sizeof(int));
+	if (!line || !walls)
+		dispError(__FUNCTION__, "Cannot allocate the line");
+	long nb = 0;
+	while (fgets(line, LINE_SIZE, f)) {
+		int g, v0, v1, winner, turns;
+		long seed, s;
+		int version[2];
+		char* moves = strrchr(line, ' ');
+		if (sscanf(line, "%d %ld %d %d %d %d", &g, &seed, &v0, &v1, &winner, &turns) != 6 || g < 0 || g >= nbJobs
+			|| !moves || winner < 0 || winner > 1)
+			continue;
+		jobGame(g, &s, version);
+		if (s != seed)
+			continue;
+		t_gameOptions opt = gameOpt;
+		opt.seed = seed;
+		t_game* game = generateArena(&opt);
+		char name[64];
+		snprintf(name, sizeof(name), "SELFPLAY_%d_%06lx", g, seed & 0xFFFFFF);
+		recordBeginGame(rec, name, game->sizeX, game->sizeY, arenaWalls(game, walls), walls, 0);
+		/* 2 moves by hexadecimal digit; the game is lost if the last move is illegal */
+		int reason = REC_BLOCKED;
+		for (int k = 0; k < turns && moves[1 + k / 2] && moves[1 + k / 2] != '\n'; k++) {
+			char c = moves[1 + k / 2];
+			int d = c <= '9' ? c - '0' : c - 'a' + 10;
+			t_move move = (k % 2 ? d >> 2 : d) & 3;
+			recordMove(rec, move);
+			if (playGameMove(game, move, NULL) != NORMAL_MOVE) {
+				reason = REC_LOST;
+				break;
+			}
+		}
+		recordEndGame(rec, winner, reason);
+		freeGame(game);
+		nb++;
+	}
+	fclose(f);
+	free(line);
+	free(walls);
+	if (recordClose(rec) < 0)
+		dispError(__FUNCTION__, "Cannot write the record file %s", recordName);
+	printf("%ld games written in %s\n", nb, recordName);
+}
+
+
+/* the coordinator: hand out the games until they are all done */
+static int coordinator(int port, const char* gameType, int nbGames, const char* fileName, const char* recordName, double timeout, double period) {
+	if (parseGameType(gameType, &gameOpt) < 0)
+		dispError(__FUNCTION__, "Invalid game options \"%s\"", gameType);
+	firstSeed = gameOpt.seed < 0 ? 1 : gameOpt.seed;
+	if (nbVersions == 0)
+		defaultParams(&versions[nbVersions++]);
+	nbPairs = nbVersions > 1 ? nbVersions * (nbVersions - 1) / 2 : 1;
+	nbJobs = nbGames;
+	jobs = calloc(nbJobs, sizeof(t_job));
+	if (!jobs)
+		dispError(__FUNCTION__, "Cannot allocate the games");
+
+	readResults(fileName);
+	if (nbDone > 0)
+		printf("Resume: %d games already done in %s\n", nbDone, fileName);
+	results = fopen(fileName, "a");
+	if (!results)
+		dispError(__FUNCTION__, "Cannot open the results file %s", fileName);
+	nbMoves = 0;
+
+	int listenfd = socket(AF_INET, SOCK_STREAM, 0);
+	if (listenfd < 0)
+		dispError(__FUNCTION__, "Impossible to open socket");
+	int one = 1;
+	setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_ANY)};
+	if (bind(listenfd, (struct sockaddr*) &addr, sizeof(addr)) < 0 || listen(listenfd, SOMAXCONN) < 0)
+		dispError(__FUNCTION__, "Cannot listen on port %d", port);
+	fcntl(listenfd, F_SETFL, O_NONBLOCK);
+
+	epfd = epoll_create1(0);
+	struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+	if (epfd < 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, listenfd, &ev) < 0)
+		dispError(__FUNCTION__, "Cannot create the epoll instance");
+	printf("Listening on port %d, %d games to play\n", port, nbJobs - nbDone);
+	fflush(stdout);
+
+	int done0 = nbDone, lastDone = nbDone;
+	double start = now(), lastStats = start;
+	struct epoll_event events[MAX_EVENTS];
+	/* wait until all the games are done, and all the workers have been told to quit */
+	while (nbDone < nbJobs || workers) {
+		int n = epoll_wait(epfd, events, MAX_EVENTS, 100);
+		if (n < 0 && errno != EINTR)
+			dispError(__FUNCTION__, "epoll_wait failed");
+		for (int i = 0; i < n; i++) {
+			t_worker* w = events[i].data.ptr;
+			if (!w)
+				acceptWorker(listenfd);
+			else if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+				readWorker(w);
+			else if (events[i].events & EPOLLOUT)
+				flush(w);
+		}
+
+		/* the silent workers with games are lost */
+		double t = now();
+		t_worker* w = workers;
+		while (w) {
+			t_worker* next = w->next;
+			if (w->nbJobs > 0 && t - w->lastSeen > timeout)
+				closeWorker(w);
+			w = next;
+		}
+		if (period > 0 && t - lastStats >= period) {
+			printf("%d/%d games, %.1f games/s, %ld workers (%ld lost), %ld games given again (%ld duplicates)\n",
+				nbDone, nbJobs, (nbDone - lastDone) / (t - lastStats), nbWorkers, nbLost, nbStolen, nbDuplicates);
+			fflush(stdout);
+			lastDone = nbDone;
+			lastStats = t;
+		}
+	}
+
+	double t = now() - start;
+	printf("%d games in %.1fs (%.1f games/s, %.0f moves/s), %ld games given again (%ld duplicates)\n",
+		nbDone - done0, t, (nbDone - done0) / t, nbMoves / t, nbStolen, nbDuplicates);
+	for (int v = 0; v < nbVersions; v++)
+		printf("version %d: %ld wins / %ld games\n", v, wins[v], played[v]);
+	fclose(results);
+	if (recordName)
+		writeRecords(fileName, recordName);
+	close(listenfd);
+	free(jobs);
+	return EXIT_SUCCESS;
+}
+
+
+/* options of the workers */
+static struct sockaddr_in serverAddr;
+static int batch = 4;
+
+
+/* thread of a worker: one connection, that plays the games given by the coordinator */
+static void* worker(void* arg) {
+	long id = (long) arg;
+	char* line = malloc(LINE_SIZE);
+	if (!line)
+		dispError(__FUNCTION__, "Cannot allocate the line");
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0 || connect(fd, (struct sockaddr*) &serverAddr, sizeof(serverAddr)) < 0)
+		dispError(__FUNCTION__, "Cannot connect to the coordinator");
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	FILE* in = fdopen(fd, "r");
+	FILE* out = fdopen(dup(fd), "w");
+	if (!in || !out)
+		dispError(__FUNCTION__, "Cannot open the connection");
+	char host[64] = "?";
+	gethostname(host, sizeof(host));
+	host[sizeof(host) - 1] = 0;
+	fprintf(out, "HELLO %.12s-%ld\n", host, id);
+	fflush(out);
+
+	/* configuration */
+	t_gameOptions opt;
+	parseGameType("", &opt);
+	int nbV;
+	t_params params[MAX_VERSIONS];
+	double budgetW;
+	if (!fgets(line, LINE_SIZE, in) || sscanf(line, "CONFIG %d %d %d %lf %d", &opt.difficulty, &opt.sizeX,
+		&opt.sizeY, &budgetW, &nbV) != 5 || nbV < 1 || nbV > MAX_VERSIONS)
+		dispError(__FUNCTION__, "Invalid configuration from the coordinator");
+	for (int v = 0; v < nbV; v++) {
+		if (!fgets(line, LINE_SIZE, in) || strncmp(line, "PARAMS", 6) != 0)
+			dispError(__FUNCTION__, "Invalid parameters from the coordinator");
+		char* p = line + 6;
+		for (int i = 0; i < NB_PARAMS; i++)
+			params[v].v[i] = strtod(p, &p);
+	}
+
+	int g[batch], version[batch][2];
+	long seed[batch];
+	long nbGames = 0;
+	char* moves = NULL;
+	t_move* played = NULL;
+	while (1) {
+		/* ask for a batch of games */
+		fprintf(out, "GET %d\n", batch);
+		fflush(out);
+		int nb = 0;
+		while (1) {
+			if (!fgets(line, LINE_SIZE, in))
+				line[0] = 0;
+			if (strncmp(line, "JOB ", 4) != 0 || nb == batch)
+				break;
+			if (sscanf(line, "JOB %d %ld %d %d", &g[nb], &seed[nb], &version[nb][0], &version[nb][1]) != 4
+				|| version[nb][0] < 0 || version[nb][0] >= nbV || version[nb][1] < 0 || version[nb][1] >= nbV)
+				dispError(__FUNCTION__, "Invalid game from the coordinator");
+			nb++;
+		}
+		if (strncmp(line, "WAIT", 4) == 0) {
+			usleep(WAIT_DELAY);
+			continue;
+		}
+		if (nb == 0)
+			break;		/* QUIT, or the coordinator is lost */
+
+		/* play them, and send the results one by one */
+		for (int i = 0; i < nb; i++) {
+			opt.seed = seed[i];
+			t_game* game = generateArena(&opt);
+			if (!played) {
+				played = malloc(MAX_MOVES(game) * sizeof(t_move));
+				moves = malloc(MAX_MOVES(game) / 2 + 2);
+				if (!played || !moves)
+					dispError(__FUNCTION__, "Cannot allocate the moves");
+			}
+			t_bot* bots[2] = {newBot(game, &params[version[i][0]]), newBot(game, &params[version[i][1]])};
+			int winner = playBotGame(game, bots, budgetW, played);
+			int turns = game->turn;
+			for (int k = 0; k < (turns + 1) / 2; k++) {
+				int d = played[2 * k] | (2 * k + 1 < turns ? played[2 * k + 1] << 2 : 0);
+				moves[k] = "0123456789abcdef"[d];
+			}
+			moves[(turns + 1) / 2] = 0;
+			fprintf(out, "RESULT %d %d %d %s\n", g[i], winner, turns, turns ? moves : "-");
+			fflush(out);
+			freeBot(bots[0]);
+			freeBot(bots[1]);
+			freeGame(game);
+			nbGames++;
+		}
+	}
+	dispDebug(__FUNCTION__, 1, "Thread %ld: %ld games played", id, nbGames);
+	fclose(in);
+	fclose(out);
+	free(line);
+	free(moves);
+	free(played);
+	return NULL;
+}
+
+
+int main(int argc, char** argv) {
+	const char* gameType = "difficulty=2 seed=1";
+	const char* server = NULL;
+	const char* fileName = "selfPlay.txt";
+	const char* recordName = NULL;
+	int isCoordinator = 0, port = DEFAULT_PORT, nbGames = 1000;
+	int nbThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	double timeout = 300, period = 10;
+	int opt;
+	while ((opt = getopt(argc, argv, "Cw:p:g:n:v:b:o:r:T:s:t:B:")) != -1) {
+		switch (opt) {
+			case 'C': isCoordinator = 1; break;
+			case 'w': server = optarg; break;
+			case 'p': port = atoi(optarg); break;
+			case 'g': gameType = optarg; break;
+			case 'n': nbGames = atoi(optarg); break;
+			case 'v':
+				if (nbVersions == MAX_VERSIONS)
+					dispError(__FUNCTION__, "Too many versions (max %d)", MAX_VERSIONS);
+				defaultParams(&versions[nbVersions]);
+				if (readParams(optarg, &versions[nbVersions++]) < 0)
+					dispError(__FUNCTION__, "Cannot read the parameters %s", optarg);
+				break;
+			case 'b': budget = atof(optarg); break;
+			case 'o': fileName = optarg; break;
+			case 'r': recordName = optarg; break;
+			case 'T': timeout = atof(optarg); break;
+			case 's': period = atof(optarg); break;
+			case 't': nbThreads = atoi(optarg); break;
+			case 'B': batch = atoi(optarg); break;
+			default:
+				server = NULL;
+				isCoordinator = 0;
+		}
+	}
+	if (isCoordinator == !!server || nbGames < 1) {
+		fprintf(stderr, "Usage: %s -C [-p port] [-g gameType] [-n games] [-v params]... [-b budget] [-o results] [-r records] [-T timeout] [-s period]\n"
+			"       %s -w server [-p port] [-t threads] [-B batch]\n", argv[0], argv[0]);
+		return EXIT_FAILURE;
+	}
+	signal(SIGPIPE, SIG_IGN);
+	if (isCoordinator)
+		return coordinator(port, gameType, nbGames, fileName, recordName, timeout, period);
+
+	/* worker */
+	if (nbThreads < 1)
+		nbThreads = 1;
+	if (batch < 1)
+		batch = 1;
+	struct hostent* host = gethostbyname(server);
+	if (!host)
+		dispError(__FUNCTION__, "No such host %s", server);
+	serverAddr.sin_family = AF_INET;
+	serverAddr.sin_port = htons(port);
+	memcpy(&serverAddr.sin_addr.s_addr, host->h_addr, host->h_length);
+	pthread_t* threads = malloc(nbThreads * sizeof(pthread_t));
+	if (!threads)
+		dispError(__FUNCTION__, "Cannot allocate the threads");
+	for (long i = 0; i < nbThreads; i++)
+		if (pthread_create(&threads[i], NULL, worker, (void*) i))
+			dispError(__FUNCTION__, "Cannot create a thread");
+	for (int i = 0; i < nbThreads; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+	return EXIT_SUCCESS;
+}
@@ -24,10 +24,36 @@ Copyright 2024 T. Hilaire
 
 #include "clientAPI.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include "snakeAPI.h"
 
+/* the optional modules are only linked when they are asked for:
+ * -DSNAKE_GAME_ALLOC (gameAlloc.c) releases the memory of the game when it ends,
+ * -DSNAKE_SEARCH_STATS (searchStats.c) follows the turns for the statistics of the search */
+#ifdef SNAKE_GAME_ALLOC
+#include "gameAlloc.h"
+#else
+static inline void gameAllocBegin() {}
+static inline void gameAllocEnd() {}
+#endif
+#ifdef SNAKE_SEARCH_STATS
+#include "searchStats.h"
+#else
+static inline double statTime() { return 0; }
+static inline void statsBeginGame(const char* gameName, const char* gameType) { (void) gameName; (void) gameType; }
+static inline void statsBeginTurn() {}
+static inline void statsEndTurn() {}
+static inline void statsWire(int send, double time) { (void) send; (void) time; }
+static inline void statsEndGame() {}
+#endif
+
 unsigned int nbW; 	/* store the nb of walls, used for getGame (the user do not have to pass them once again */
 
+#define MAX_LISTENERS 8
+static t_moveListener listeners[MAX_LISTENERS];	/* functions called after each move, and their data */
+static void* listenersData[MAX_LISTENERS];
+static int nbListeners = 0;
+
 
 /* -------------------------------------
  * Initialize connection with the server
@@ -91,6 +117,10 @@ void waitForSnakeGame(char* gameType, char* gameName, int* sizeX, int* sizeY, in
 
 	/* store the nb of walls, so that we can reuse it during getSnakeGameData */
 	nbW = *nbWalls;
+
+	/* the memory of the previous game is released */
+	gameAllocBegin();
+	statsBeginGame(gameName, gameType);
 }
 
 
@@ -104,11 +134,15 @@ void waitForSnakeGame(char* gameType, char* gameName, int* sizeX, int* sizeY, in
  * Returns 0 if you begin, or 1 if the opponent begins
  */
 int getSnakeArena(int* walls) {
-	char data[4096*8];
+	/* each wall is given by 4 integers (at most 11 characters each, with the space) */
+	size_t size = 44 * nbW + 64;
+	char *data = malloc(size);
+	if (!data)
+		dispError(__FUNCTION__, "Cannot allocate the arena");
 	char *p = data;
 	int n;
 	/* wait for a game */
-	int ret = getGameData(__FUNCTION__, data, 4096*8);
+	int ret = getGameData(__FUNCTION__, data, size);
 
 	/* copy the data in the array walls, the data is a readable string of integers */
 	for(int i=0; i<nbW; i++) {
@@ -116,7 +150,11 @@ int getSnakeArena(int* walls) {
 		walls += 4;
 		p += n;
 	}
+	free(data);
 
+	/* our first turn begins if we start */
+	if (ret == 0)
+		statsBeginTurn();
     return ret;
 }
 
@@ -139,11 +177,23 @@ t_return_code getMove(t_move* move ) {
     char msg[MAX_MESSAGE];
 
     /* get the move */
+	double t = statTime();
     int ret = getCGSMove(__FUNCTION__, data, msg);
+	statsWire(0, statTime() - t);
 
 	/* extract move */
 	sscanf(data, "%d", (int*) move);
 	dispDebug(__FUNCTION__,2,"move: %d, ret: %d", *move, ret);
+	for (int i = 0; i < nbListeners; i++)
+		listeners[i](*move, 0, ret, listenersData[i]);
+
+	/* end of the game: release its memory; otherwise, our turn begins */
+	if (ret != NORMAL_MOVE) {
+		statsEndGame();
+		gameAllocEnd();
+	}
+	else
+		statsBeginTurn();
 	return ret;
 }
 
@@ -167,8 +217,20 @@ t_return_code sendMove(t_move move) {
     char answer[MAX_MESSAGE];
     sprintf( data, "%d", move);
 	dispDebug(__FUNCTION__, 2, "move sent : %s", data);
-    /* send the move */
-	return sendCGSMove(__FUNCTION__, data, answer);
+    /* send the move (our turn ends) */
+	statsEndTurn();
+	double t = statTime();
+	t_return_code ret = sendCGSMove(__FUNCTION__, data, answer);
+	statsWire(1, statTime() - t);
+	for (int i = 0; i < nbListeners; i++)
+		listeners[i](move, 1, ret, listenersData[i]);
+
+	/* end of the game: release its memory */
+	if (ret != NORMAL_MOVE) {
+		statsEndGame();
+		gameAllocEnd();
+	}
+	return ret;
 }
 
 
@@ -192,3 +254,38 @@ void printArena() {
 void sendComment(char* comment) {
     sendCGSComment( __FUNCTION__, comment);
 }
+
+
+
+/* ---------------------------------------------------------------------
+ * Register a function called after each move sent (`sendMove`, ours=1)
+ * or received (`getMove`, ours=0), with its return code (as returned by
+ * `sendMove`/`getMove`), so that the local data can follow the game
+ *
+ * Parameters:
+ * - listener: the function
+ * - data: pointer given to the function
+ */
+void addMoveListener(t_moveListener listener, void* data) {
+	if (nbListeners == MAX_LISTENERS)
+		dispError(__FUNCTION__, "Too many listeners (max %d)", MAX_LISTENERS);
+	listeners[nbListeners] = listener;
+	listenersData[nbListeners++] = data;
+}
+
+
+
+/* ---------------------------------------------------------------------
+ * Unregister a function (registered with the same data)
+ */
+void removeMoveListener(t_moveListener listener, void* data) {
+	for (int i = 0; i < nbListeners; i++)
+		if (listeners[i] == listener && listenersData[i] == data) {
+			nbListeners--;
+			for (; i < nbListeners; i++) {
+				listeners[i] = listeners[i + 1];
+				listenersData[i] = listenersData[i + 1];
+			}
+			return;
+		}
+}
@@ -152,4 +152,27 @@ void sendComment(char* comment);
 
 
 
+/* A function called after each move (see `addMoveListener`) */
+typedef void (*t_moveListener)(t_move move, int ours, t_return_code ret, void* data);
+
+
+/* ---------------------------------------------------------------------
+ * Register a function called after each move sent (`sendMove`, ours=1)
+ * or received (`getMove`, ours=0), with its return code (as returned by
+ * `sendMove`/`getMove`), so that the local data can follow the game
+ *
+ * Parameters:
+ * - listener: the function
+ * - data: pointer given to the function
+ */
+void addMoveListener(t_moveListener listener, void* data);
+
+
+/* ---------------------------------------------------------------------
+ * Unregister a function (registered with the same data)
+ */
+void removeMoveListener(t_moveListener listener, void* data);
+
+
+
 #endif
@@ -0,0 +1,395 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: snakeBot.c
+	A bot (alpha-beta search with a weighted evaluation), whose
+	evaluation weights and search parameters can be tuned
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "clientAPI.h"
+#include "endgame.h"
+#include "searchStats.h"
+#include "snakeBot.h"
+
+
+#define WIN 1e9						/* score of a won position */
+#define ENDGAME_DEFAULT_BUDGET 0.02	/* budget of the endgame solver when the bot has no time limit */
+
+
+/* name, default value, min, max, step (a step of 0 means the parameter is not tuned) */
+const t_paramInfo paramInfo[NB_PARAMS] = {
+	{"depth", 4, 1, 12, 0},
+	{"voronoi", 1.0, 0, 10, 0.25},
+	{"reach", 0.5, 0, 10, 0.25},
+	{"chamber", 0.0, 0, 10, 0.25},
+	{"mobility", 2.0, -10, 10, 0.5},
+	{"headDist", 0.0, -5, 5, 0.2},
+	{"wallHug", 0.5, -5, 5, 0.2},
+	{"closeTie", 0.5, 0, 1, 0.1},
+	{"endgame", 1, 0, 1, 0},
+	{"endgameTime", 0.5, 0.05, 1, 0.05},
+};
+
+
+/* current time, in seconds */
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+
+/* -------------------------------------
+ * Set the parameters to their default values
+ */
+void defaultParams(t_params* params) {
+	for (int i = 0; i < NB_PARAMS; i++)
+		params->v[i] = paramInfo[i].def;
+}
+
+
+/* -------------------------------------------------------------------
+ * Read/write the parameters in a file (one line "name=value" by parameter)
+ * The parameters not given in the file keep their value
+ *
+ * Returns 0 if the file can be read/written, -1 otherwise
+ */
+int readParams(const char* fileName, t_params* params) {
+	FILE* f = fopen(fileName, "r");
+	if (!f)
+		return -1;
+	char line[256], name[128];
+	double v;
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, " %127[^= ] = %lf", name, &v) != 2)
+			continue;
+		for (int i = 0; i < NB_PARAMS; i++)
+			if (strcmp(name, paramInfo[i].name) == 0)
+				params->v[i] = v;
+	}
+	fclose(f);
+	return 0;
+}
+
+int writeParams(const char* fileName, const t_params* params) {
+	FILE* f = fopen(fileName, "w");
+	if (!f)
+		return -1;
+	for (int i = 0; i < NB_PARAMS; i++)
+		fprintf(f, "%s=%.17g\n", paramInfo[i].name, params->v[i]);
+	return fclose(f) ? -1 : 0;
+}
+
+
+/* -----------------------------------------------------------------
+ * Create a bot for a game (the game is only used for its size)
+ * params can be NULL (default values)
+ */
+t_bot* newBot(const t_game* game, const t_params* params) {
+	t_bot* bot = malloc(sizeof(t_bot));
+	if (!bot)
+		dispError(__FUNCTION__, "Cannot allocate the bot");
+	if (params)
+		bot->params = *params;
+	else
+		defaultParams(&bot->params);
+	bot->game = newGame(game->sizeX, game->sizeY, 0, NULL);
+	copyGame(bot->game, game);
+	bot->chambers = newChambers(bot->game);
+	bot->endgame = newEndgame(bot->game);
+	bot->dist[0] = malloc(game->nbCells * sizeof(int));
+	bot->dist[1] = malloc(game->nbCells * sizeof(int));
+	bot->queue = malloc(game->nbCells * sizeof(int));
+	if (!bot->dist[0] || !bot->dist[1] || !bot->queue)
+		dispError(__FUNCTION__, "Cannot allocate the work arrays");
+	bot->nbNodes = 0;
+	bot->timeout = 0;
+	bot->deadline = 0;
+	bot->score = 0;
+	bot->tablebase = NULL;
+	return bot;
+}
+
+
+/* ----------
+ * Free a bot
+ */
+void freeBot(t_bot* bot) {
+	if (!bot)
+		return;
+	freeChambers(bot->chambers);
+	freeEndgame(bot->endgame);
+	freeGame(bot->game);
+	free(bot->dist[0]);
+	free(bot->dist[1]);
+	free(bot->queue);
+	free(bot);
+}
+
+
+/* BFS from the head of the snake p through the free cells (dist is -1 for the unreached cells)
+ * Returns the number of reached cells */
+static int bfs(t_bot* bot, const t_game* game, int p) {
+	int* dist = bot->dist[p];
+	int* queue = bot->queue;
+	int nb = 0, first = 0, last = 0;
+	for (int c = 0; c < game->nbCells; c++)
+		dist[c] = -1;
+	int h = snakeHead(game, p);
+	dist[h] = 0;
+	queue[last++] = h;
+	while (first < last) {
+		int c = queue[first++];
+		for (int d = 0; d < 4; d++) {
+			int n = game->next[4 * c + d];
+			if (n >= 0 && !game->occupied[n] && dist[n] < 0) {
+				dist[n] = dist[c] + 1;
+				queue[last++] = n;
+				nb++;
+			}
+		}
+	}
+	return nb;
+}
+
+
+/* number of free neighbours and of walls (or borders) around the head of the snake p */
+static void headNeighbours(const t_game* game, int p, int* free, int* walls) {
+	int h = snakeHead(game, p);
+	*free = *walls = 0;
+	for (int d = 0; d < 4; d++) {
+		int n = game->next[4 * h + d];
+		if (n < 0)
+			(*walls)++;
+		else if (!game->occupied[n])
+			(*free)++;
+	}
+}
+
+
+/* --------------------------------------------------------------------------
+ * Evaluate the position for the player p (the higher the better)
+ */
+double evaluate(t_bot* bot, const t_game* game, int p) {
+	const double* w = bot->params.v;
+	int q = 1 - p;
+	int reach[2];
+	reach[p] = bfs(bot, game, p);
+	reach[q] = bfs(bot, game, q);
+
+	/* Voronoi: cells strictly closer to one of the players, the tied cells are shared */
+	double vor = 0, tie = game->turn % 2 == p ? w[P_CLOSE_TIE] : 1 - w[P_CLOSE_TIE];
+	int headDist = -1, oppHead = snakeHead(game, q);
+	for (int c = 0; c < game->nbCells; c++) {
+		int dp = bot->dist[p][c], dq = bot->dist[q][c];
+		if (dp <= 0 && dq <= 0)
+			continue;
+		if (dq <= 0 || (dp > 0 && dp < dq))
+			vor += 1;
+		else if (dp <= 0 || dq < dp)
+			vor -= 1;
+		else
+			vor += 2 * tie - 1;
+	}
+	for (int d = 0; d < 4; d++) {
+		int n = game->next[4 * oppHead + d];
+		if (n >= 0 && bot->dist[p][n] > 0 && (headDist < 0 || bot->dist[p][n] + 1 < headDist))
+			headDist = bot->dist[p][n] + 1;
+	}
+
+	int freeP, wallP, freeQ, wallQ;
+	headNeighbours(game, p, &freeP, &wallP);
+	headNeighbours(game, q, &freeQ, &wallQ);
+
+	double score = w[P_VORONOI] * vor + w[P_REACH] * (reach[p] - reach[q])
+		+ w[P_MOBILITY] * (freeP - freeQ) + w[P_WALL_HUG] * (wallP - wallQ)
+		+ w[P_HEAD_DIST] * (headDist < 0 ? 0 : headDist);
+	if (w[P_CHAMBER] != 0) {
+		/* the search keeps the chambers of its copy of the game up to date */
+		if (game != bot->game)
+			updateChambers(bot->chambers, game);
+		score += w[P_CHAMBER] * evalChambers(bot->chambers, game, p);
+	}
+	return score;
+}
+
+
+/* keep the chambers up to date with the copy of the game of the bot, after each move played or undone
+ * (so that each update is incremental: only one head and tail have changed) */
+static inline void followChambers(t_bot* bot) {
+	if (bot->params.v[P_CHAMBER] != 0)
+		updateChambers(bot->chambers, bot->game);
+}
+
+
+/* negamax with alpha-beta pruning, on the copy of the game of the bot */
+static double search(t_bot* bot, int depth, double alpha, double beta, int ply) {
+	t_game* game = bot->game;
+	STAT_NODE();
+	if ((++bot->nbNodes & 255) == 0 && bot->deadline > 0 && now() > bot->deadline)
+		bot->timeout = 1;
+	if (bot->timeout)
+		return 0;
+
+	t_move moves[4];
+	int nb = legalMoves(game, moves);
+	if (nb == 0)
+		return -WIN + ply;
+	if (depth == 0) {
+		double t = STAT_CLOCK();
+		double v = evaluate(bot, game, game->turn % 2);
+		STAT_EVAL(STAT_CLOCK() - t);
+		return v;
+	}
+
+	double best = -2 * WIN;
+	t_undo undo;
+	for (int i = 0; i < nb; i++) {
+		playGameMove(game, moves[i], &undo);
+		followChambers(bot);
+		double v = -search(bot, depth - 1, -beta, -alpha, ply + 1);
+		undoGameMove(game, &undo);
+		followChambers(bot);
+		if (v > best)
+			best = v;
+		if (v > alpha)
+			alpha = v;
+		if (alpha >= beta) {
+			STAT_CUTOFF(i == 0);
+			break;
+		}
+	}
+	return best;
+}
+
+
+/* --------------------------------------------------------------------------
+ * Choose the move for the player that has to play
+ *
+ * Parameters:
+ * - bot: the bot
+ * - game: the game
+ * - budget: time budget in seconds (0 for no limit: the search goes to the depth given by the parameters)
+ *
+ * Returns the move (its score is in bot->score: the value of the deepest search completed,
+ * or the evaluation of the position when there is nothing to search)
+ */
+t_move botMove(t_bot* bot, const t_game* game, double budget) {
+	const double* w = bot->params.v;
+	double start = now();
+	t_move moves[4];
+	int nb = legalMoves(game, moves);
+	if (nb == 0) {
+		bot->score = -WIN;
+		return NORTH;
+	}
+	if (nb == 1) {
+		bot->score = evaluate(bot, game, game->turn % 2);
+		return moves[0];
+	}
+
+	/* small arena: the tablebase gives the exact value (the fastest win, or the longest loss) */
+	if (bot->tablebase && tbMatches(bot->tablebase, game)) {
+		t_move move;
+		int dist;
+		copyGame(bot->game, game);
+		int v = tbBestMove(bot->tablebase, bot->game, &move, &dist);
+		if (v == TB_WIN || v == TB_LOSS) {
+			bot->score = v == TB_WIN ? WIN - dist : -WIN + dist;
+			return move;
+		}
+	}
+
+	/* separated snakes: the endgame solver knows better */
+	if (w[P_ENDGAME] >= 0.5) {
+		t_move move;
+		if (endgameMove(bot->endgame, game, budget > 0 ? budget * w[P_ENDGAME_TIME] : ENDGAME_DEFAULT_BUDGET, &move)) {
+			bot->score = evaluate(bot, game, game->turn % 2);
+			return move;
+		}
+	}
+
+	/* iterative deepening (the best move of the previous depth is searched first) */
+	copyGame(bot->game, game);
+	followChambers(bot);
+	bot->timeout = 0;
+	bot->deadline = budget > 0 ? start + budget : 0;
+	int maxDepth = (int) w[P_DEPTH];
+	t_move best = moves[0];
+	t_undo undo;
+	bot->score = evaluate(bot, bot->game, game->turn % 2);
+	for (int depth = 1; depth <= maxDepth; depth++) {
+		double alpha = -2 * WIN;
+		int iBest = 0;
+		for (int i = 0; i < nb; i++) {
+			playGameMove(bot->game, moves[i], &undo);
+			followChambers(bot);
+			double v = -search(bot, depth - 1, -2 * WIN, -alpha, 1);
+			undoGameMove(bot->game, &undo);
+			followChambers(bot);
+			if (bot->timeout)
+				break;
+			if (v > alpha) {
+				alpha = v;
+				iBest = i;
+			}
+		}
+		if (bot->timeout)
+			break;
+		STAT_DEPTH(depth);
+		bot->score = alpha;
+		best = moves[iBest];
+		moves[iBest] = moves[0];
+		moves[0] = best;
+		/* won or lost: no need to search deeper */
+		if (alpha > WIN / 2 || alpha < -WIN / 2)
+			break;
+	}
+	dispDebug(__FUNCTION__, 2, "move %d (%ld nodes, %.3fs)", best, bot->nbNodes, now() - start);
+	return best;
+}
+
+
+/* ------------------------------------------------------------------
+ * Play a whole game between two bots (bots[p] plays for the player p)
+ *
+ * Parameters:
+ * - game: the game (at its starting position), modified by the moves
+ * - bots: the two bots
+ * - budget: time budget for each move (0 for no limit)
+ * - moves: (can be NULL) filled with the moves played (the array must have MAX_MOVES(game) entries)
+ *
+ * Returns the winner (0 or 1)
+ */
+int playBotGame(t_game* game, t_bot* bots[2], double budget, t_move* moves) {
+	t_move legal[4];
+	while (legalMoves(game, legal) > 0) {
+		int p = game->turn % 2;
+		t_move move = botMove(bots[p], game, budget);
+		if (moves)
+			moves[game->turn] = move;
+		if (playGameMove(game, move, NULL) != NORMAL_MOVE)
+			return 1 - p;
+	}
+	return 1 - game->turn % 2;
+}
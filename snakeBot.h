@@ -0,0 +1,146 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: snakeBot.h
+	A bot (alpha-beta search with a weighted evaluation), whose
+	evaluation weights and search parameters can be tuned
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_BOT__
+#define __SNAKE_BOT__
+#include "snakeGame.h"
+#include "chamber.h"
+#include "endgame.h"
+#include "tablebase.h"
+
+
+/* Parameters of the bot */
+enum {
+	P_DEPTH,			/* maximal depth of the search (in plies) */
+	P_VORONOI,			/* weight of the difference of the cells closer to us than to the opponent */
+	P_REACH,			/* weight of the difference of the reachable cells */
+	P_CHAMBER,			/* weight of the difference of the fillable lengths (chambers decomposition) */
+	P_MOBILITY,			/* weight of the difference of the number of legal moves */
+	P_HEAD_DIST,		/* weight of the distance between the heads */
+	P_WALL_HUG,			/* weight of the number of blocked neighbours of our head */
+	P_CLOSE_TIE,		/* share of the tied cells (same distance) given to the player that has to play */
+	P_ENDGAME,			/* use the endgame solver when the snakes are separated (if >= 0.5) */
+	P_ENDGAME_TIME,		/* share of the time budget given to the endgame solver */
+	NB_PARAMS
+};
+
+
+/* Description of a parameter */
+typedef struct {
+	const char* name;
+	double def;			/* default value */
+	double min, max;	/* range */
+	double step;		/* typical perturbation (used by the tuner) */
+} t_paramInfo;
+
+extern const t_paramInfo paramInfo[NB_PARAMS];
+
+
+/* Values of the parameters */
+typedef struct {
+	double v[NB_PARAMS];
+} t_params;
+
+
+/* A bot (with its working memory, one per thread) */
+typedef struct {
+	t_params params;
+	t_game* game;			/* copy of the game, used for the search */
+	t_chambers* chambers;
+	t_endgame* endgame;		/* working memory of the endgame solver */
+	int *dist[2], *queue;	/* work arrays for the BFS */
+	long nbNodes;
+	int timeout;
+	double deadline;
+	double score;			/* score of the last move chosen by `botMove` (for the player that has played it) */
+	const t_tablebase* tablebase;	/* tablebase of the arena, consulted first by `botMove` (NULL if none) */
+} t_bot;
+
+
+
+/* -------------------------------------
+ * Set the parameters to their default values
+ */
+void defaultParams(t_params* params);
+
+
+/* -------------------------------------------------------------------
+ * Read/write the parameters in a file (one line "name=value" by parameter)
+ * The parameters not given in the file keep their value
+ *
+ * Returns 0 if the file can be read/written, -1 otherwise
+ */
+int readParams(const char* fileName, t_params* params);
+int writeParams(const char* fileName, const t_params* params);
+
+
+/* -----------------------------------------------------------------
+ * Create a bot for a game (the game is only used for its size)
+ * params can be NULL (default values)
+ */
+t_bot* newBot(const t_game* game, const t_params* params);
+
+
+/* ----------
+ * Free a bot
+ */
+void freeBot(t_bot* bot);
+
+
+/* --------------------------------------------------------------------------
+ * Evaluate the position for the player p (the higher the better)
+ */
+double evaluate(t_bot* bot, const t_game* game, int p);
+
+
+/* --------------------------------------------------------------------------
+ * Choose the move for the player that has to play
+ *
+ * Parameters:
+ * - bot: the bot
+ * - game: the game
+ * - budget: time budget in seconds (0 for no limit: the search goes to the depth given by the parameters)
+ *
+ * Returns the move (its score is in bot->score: the value of the deepest search completed,
+ * or the evaluation of the position when there is nothing to search)
+ */
+t_move botMove(t_bot* bot, const t_game* game, double budget);
+
+
+/* ------------------------------------------------------------------
+ * Play a whole game between two bots (bots[p] plays for the player p)
+ *
+ * Parameters:
+ * - game: the game (at its starting position), modified by the moves
+ * - bots: the two bots
+ * - budget: time budget for each move (0 for no limit)
+ * - moves: (can be NULL) filled with the moves played (the array must have MAX_MOVES(game) entries)
+ *
+ * Returns the winner (0 or 1)
+ */
+int playBotGame(t_game* game, t_bot* bots[2], double budget, t_move* moves);
+
+
+#endif
@@ -0,0 +1,274 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: snakeGame.c
+	Local representation of a Snake game (arena, walls and both snakes)
+	-> used to simulate the moves without asking the server
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "clientAPI.h"
+#include "snakeGame.h"
+
+
+/* displacement associated to each move (NORTH, EAST, SOUTH, WEST) */
+static const int dx[4] = {0, 1, 0, -1};
+static const int dy[4] = {-1, 0, 1, 0};
+
+
+/* ---------------------------------------------------
+ * Create a game with the arena given by the server
+ * (the snakes are at their starting position)
+ *
+ * Parameters:
+ * - sizeX, sizeY: size of the arena (given by `waitForSnakeGame`)
+ * - nbWalls: number of walls
+ * - walls: array of nbWalls*4 integers (given by `getSnakeArena`)
+ *
+ * Returns the game (to be freed with `freeGame`)
+ */
+t_game* newGame(int sizeX, int sizeY, int nbWalls, const int* walls) {
+	if (sizeX < 5 || sizeY < 1)
+		dispError(__FUNCTION__, "Invalid arena size (%dx%d)", sizeX, sizeY);
+
+	t_game* game = malloc(sizeof(t_game));
+	if (!game)
+		dispError(__FUNCTION__, "Cannot allocate the game");
+	game->sizeX = sizeX;
+	game->sizeY = sizeY;
+	game->nbCells = sizeX * sizeY;
+	game->next = malloc(4 * game->nbCells * sizeof(int));
+	game->occupied = calloc(game->nbCells, 1);
+	game->snake[0].body = malloc(game->nbCells * sizeof(int));
+	game->snake[1].body = malloc(game->nbCells * sizeof(int));
+	if (!game->next || !game->occupied || !game->snake[0].body || !game->snake[1].body)
+		dispError(__FUNCTION__, "Cannot allocate the game");
+
+	/* neighbours (the borders are walls) */
+	for (int y = 0; y < sizeY; y++)
+		for (int x = 0; x < sizeX; x++)
+			for (int d = 0; d < 4; d++) {
+				int nx = x + dx[d], ny = y + dy[d];
+				game->next[4 * CELL(game, x, y) + d] =
+					(nx >= 0 && nx < sizeX && ny >= 0 && ny < sizeY) ? CELL(game, nx, ny) : -1;
+			}
+
+	/* remove the walls (a wall is between two adjacent cells) */
+	for (int i = 0; i < nbWalls; i++) {
+		const int* w = walls + 4 * i;
+		if (w[0] < 0 || w[0] >= sizeX || w[1] < 0 || w[1] >= sizeY || w[2] < 0 || w[2] >= sizeX || w[3] < 0 || w[3] >= sizeY)
+			dispError(__FUNCTION__, "Invalid wall (%d,%d)-(%d,%d)", w[0], w[1], w[2], w[3]);
+		int c1 = CELL(game, w[0], w[1]), c2 = CELL(game, w[2], w[3]);
+		for (int d = 0; d < 4; d++) {
+			if (game->next[4 * c1 + d] == c2)
+				game->next[4 * c1 + d] = -1;
+			if (game->next[4 * c2 + d] == c1)
+				game->next[4 * c2 + d] = -1;
+		}
+	}
+
+	/* each arena has its own identifier (the neighbours are only written here) */
+	static unsigned int nbArenas = 0;
+	game->arenaId = __atomic_add_fetch(&nbArenas, 1, __ATOMIC_RELAXED);
+
+	/* snakes at their starting positions */
+	for (int p = 0; p < 2; p++) {
+		t_snake* s = &game->snake[p];
+		s->head = 0;
+		s->length = 1;
+		s->nbMoves = 0;
+		s->body[0] = CELL(game, p ? sizeX - 3 : 2, sizeY / 2);
+		game->occupied[s->body[0]] = p + 1;
+	}
+	game->turn = 0;
+
+	return game;
+}
+
+
+/* --------------
+ * Free a game
+ */
+void freeGame(t_game* game) {
+	if (!game)
+		return;
+	free(game->next);
+	free(game->occupied);
+	free(game->snake[0].body);
+	free(game->snake[1].body);
+	free(game);
+}
+
+
+/* ----------------------------------------------------
+ * Copy a game into another one (with the same arena size)
+ */
+void copyGame(t_game* dest, const t_game* src) {
+	if (dest->nbCells != src->nbCells)
+		dispError(__FUNCTION__, "The two games do not have the same size");
+	dest->sizeX = src->sizeX;
+	dest->sizeY = src->sizeY;
+	dest->turn = src->turn;
+	memcpy(dest->next, src->next, 4 * src->nbCells * sizeof(int));
+	dest->arenaId = src->arenaId;
+	memcpy(dest->occupied, src->occupied, src->nbCells);
+	for (int p = 0; p < 2; p++) {
+		int* body = dest->snake[p].body;
+		dest->snake[p] = src->snake[p];
+		dest->snake[p].body = body;
+		memcpy(body, src->snake[p].body, src->nbCells * sizeof(int));
+	}
+}
+
+
+/* -----------------------------------------------------------
+ * Returns the k-th cell of the snake p (k=0 for the head)
+ */
+int snakeCell(const t_game* game, int p, int k) {
+	const t_snake* s = &game->snake[p];
+	int i = s->head - k;
+	return s->body[i < 0 ? i + game->nbCells : i];
+}
+
+
+/* ---------------------------------
+ * Returns the head/tail of the snake p
+ */
+int snakeHead(const t_game* game, int p) {
+	return game->snake[p].body[game->snake[p].head];
+}
+
+int snakeTail(const t_game* game, int p) {
+	return snakeCell(game, p, game->snake[p].length - 1);
+}
+
+
+/* ------------------------------------------------------------
+ * Indicates if the snake p grows on its next move (1) or not (0)
+ */
+int snakeGrows(const t_game* game, int p) {
+	return game->snake[p].nbMoves % GROWTH_PERIOD == 0;
+}
+
+
+/* ----------------------------------------------------------
+ * Length of a snake after it has played nbMoves moves
+ * (it starts with one cell and grows on its moves 0, 10, 20, ...)
+ */
+int snakeLength(int nbMoves) {
+	return 1 + (nbMoves + GROWTH_PERIOD - 1) / GROWTH_PERIOD;
+}
+
+
+/* --------------------------------------------------------------
+ * Indicates if the move is legal for the player that has to play
+ * The tail of the player is considered as free (it leaves its cell during the move)
+ * when the snake does not grow
+ *
+ * Returns 1 if the move is legal, 0 otherwise
+ */
+int isMoveLegal(const t_game* game, t_move move) {
+	int p = game->turn % 2;
+	int c = game->next[4 * snakeHead(game, p) + move];
+	if (c < 0)
+		return 0;
+	if (!game->occupied[c])
+		return 1;
+	return c == snakeTail(game, p) && !snakeGrows(game, p);
+}
+
+
+/* --------------------------------------------------
+ * Fill the array moves with the legal moves of the player that has to play
+ *
+ * Returns the number of legal moves
+ */
+int legalMoves(const t_game* game, t_move moves[4]) {
+	int n = 0;
+	for (t_move m = NORTH; m <= WEST; m++)
+		if (isMoveLegal(game, m))
+			moves[n++] = m;
+	return n;
+}
+
+
+/* -----------------------------------------------------
+ * Play a move for the player that has to play
+ *
+ * Parameters:
+ * - game: the game
+ * - move: the move
+ * - undo: (can be NULL) filled with the information needed to undo the move
+ *
+ * Returns LOSING_MOVE if the move is illegal (the game is then unchanged), NORMAL_MOVE otherwise
+ */
+t_return_code playGameMove(t_game* game, t_move move, t_undo* undo) {
+	if (!isMoveLegal(game, move))
+		return LOSING_MOVE;
+
+	int p = game->turn % 2;
+	t_snake* s = &game->snake[p];
+	int c = game->next[4 * snakeHead(game, p) + move];
+	int freed = -1;
+
+	/* the tail leaves its cell (except when the snake grows) */
+	if (snakeGrows(game, p))
+		s->length++;
+	else {
+		freed = snakeTail(game, p);
+		game->occupied[freed] = 0;
+	}
+
+	/* new head */
+	s->head = (s->head + 1) % game->nbCells;
+	s->body[s->head] = c;
+	game->occupied[c] = p + 1;
+	s->nbMoves++;
+	game->turn++;
+
+	if (undo) {
+		undo->player = p;
+		undo->freedTail = freed;
+	}
+	return NORMAL_MOVE;
+}
+
+
+/* ----------------------------------
+ * Undo the last move played
+ */
+void undoGameMove(t_game* game, const t_undo* undo) {
+	int p = undo->player;
+	t_snake* s = &game->snake[p];
+
+	game->turn--;
+	s->nbMoves--;
+	game->occupied[s->body[s->head]] = 0;
+	s->head = (s->head ? s->head : game->nbCells) - 1;
+
+	if (undo->freedTail < 0)
+		s->length--;
+	else {
+		/* the slot of the tail may have been reused by a later head */
+		int i = s->head - s->length + 1;
+		s->body[i < 0 ? i + game->nbCells : i] = undo->freedTail;
+		game->occupied[undo->freedTail] = p + 1;
+	}
+}
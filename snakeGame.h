@@ -0,0 +1,159 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: snakeGame.h
+	Local representation of a Snake game (arena, walls and both snakes)
+	-> used to simulate the moves without asking the server
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_GAME__
+#define __SNAKE_GAME__
+#include "snakeAPI.h"
+
+
+#define GROWTH_PERIOD 10		/* each snake grows every 10 turns (turn 0 included) */
+
+/* maximal number of moves of a game (a snake cannot be longer than the arena) */
+#define MAX_MOVES(game) (2 * GROWTH_PERIOD * (game)->nbCells)
+
+/* index of the cell (x,y) in the arrays of a game */
+#define CELL(game, x, y) ((y) * (game)->sizeX + (x))
+
+
+/* A snake is stored as a ring buffer of cells (the head is body[head]) */
+typedef struct {
+	int* body;			/* ring buffer of cell indexes (capacity: nbCells) */
+	int head;			/* position of the head in body */
+	int length;			/* number of cells of the snake */
+	int nbMoves;		/* number of moves already played by the snake */
+} t_snake;
+
+
+/* A game: the arena and the two snakes
+ * Player 0 is the one that plays first (it starts at (2,H/2)), player 1 starts at (L-3,H/2) */
+typedef struct {
+	int sizeX, sizeY;	/* size of the arena */
+	int nbCells;		/* sizeX*sizeY */
+	int* next;			/* next[4*c+d] is the neighbour of cell c in direction d, or -1 (wall or border) */
+	unsigned int arenaId;	/* identifier of the arena, given by `newGame` and kept by `copyGame` */
+	unsigned char* occupied;	/* 0 for a free cell, p+1 if the cell is occupied by the snake p */
+	t_snake snake[2];
+	int turn;			/* number of moves already played (both players), the player turn%2 has to play */
+} t_game;
+
+
+/* Information needed to undo a move */
+typedef struct {
+	int player;			/* player that has played */
+	int freedTail;		/* cell freed by the move (-1 if the snake has grown) */
+} t_undo;
+
+
+
+/* ---------------------------------------------------
+ * Create a game with the arena given by the server
+ * (the snakes are at their starting position)
+ *
+ * Parameters:
+ * - sizeX, sizeY: size of the arena (given by `waitForSnakeGame`)
+ * - nbWalls: number of walls
+ * - walls: array of nbWalls*4 integers (given by `getSnakeArena`)
+ *
+ * Returns the game (to be freed with `freeGame`)
+ */
+t_game* newGame(int sizeX, int sizeY, int nbWalls, const int* walls);
+
+
+/* --------------
+ * Free a game
+ */
+void freeGame(t_game* game);
+
+
+/* ----------------------------------------------------
+ * Copy a game into another one (with the same arena size)
+ */
+void copyGame(t_game* dest, const t_game* src);
+
+
+/* -----------------------------------------------------------
+ * Returns the k-th cell of the snake p (k=0 for the head)
+ */
+int snakeCell(const t_game* game, int p, int k);
+
+
+/* ---------------------------------
+ * Returns the head/tail of the snake p
+ */
+int snakeHead(const t_game* game, int p);
+int snakeTail(const t_game* game, int p);
+
+
+/* ------------------------------------------------------------
+ * Indicates if the snake p grows on its next move (1) or not (0)
+ */
+int snakeGrows(const t_game* game, int p);
+
+
+/* ----------------------------------------------------------
+ * Length of a snake after it has played nbMoves moves
+ * (it starts with one cell and grows on its moves 0, 10, 20, ...)
+ */
+int snakeLength(int nbMoves);
+
+
+/* --------------------------------------------------------------
+ * Indicates if the move is legal for the player that has to play
+ * The tail of the player is considered as free (it leaves its cell during the move)
+ * when the snake does not grow
+ *
+ * Returns 1 if the move is legal, 0 otherwise
+ */
+int isMoveLegal(const t_game* game, t_move move);
+
+
+/* --------------------------------------------------
+ * Fill the array moves with the legal moves of the player that has to play
+ *
+ * Returns the number of legal moves
+ */
+int legalMoves(const t_game* game, t_move moves[4]);
+
+
+/* -----------------------------------------------------
+ * Play a move for the player that has to play
+ *
+ * Parameters:
+ * - game: the game
+ * - move: the move
+ * - undo: (can be NULL) filled with the information needed to undo the move
+ *
+ * Returns LOSING_MOVE if the move is illegal (the game is then unchanged), NORMAL_MOVE otherwise
+ */
+t_return_code playGameMove(t_game* game, t_move move, t_undo* undo);
+
+
+/* ----------------------------------
+ * Undo the last move played
+ */
+void undoGameMove(t_game* game, const t_undo* undo);
+
+
+#endif
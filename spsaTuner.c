@@ -0,0 +1,241 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: spsaTuner.c
+	Tuning of the parameters of the bot (snakeBot.h) by SPSA on self-play games
+	(played locally, in parallel, without the server)
+
+	At each iteration, all the tuned parameters are perturbed at once (+/- c_k steps),
+	and the two perturbed bots play pairs of games on the same arenas (each one
+	starting once); the parameters are then moved toward the bot that won more.
+
+	Usage: spsaTuner [-g gameType] [-t threads] [-n iterations] [-p pairs]
+	                 [-b budget] [-c checkpoint] [-a a] [-C c]
+	  -g: options of the games, with the syntax of `waitForSnakeGame`
+	      ("difficulty=2 seed=123 sizeX=40 sizeY=20"), the seed is the one of the first arena
+	  -t: number of threads (number of cores by default)
+	  -n: number of iterations (100 by default)
+	  -p: number of pairs of games by iteration (2 per thread by default)
+	  -b: time budget of each move in seconds (0 by default: fixed depth)
+	  -c: checkpoint file (read at start if it exists, written after each iteration)
+	  -a, -C: SPSA gains (step size and perturbation size, in steps of the parameters)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "clientAPI.h"
+#include "arenaGen.h"
+#include "snakeBot.h"
+
+
+#define SPSA_ALPHA 0.602		/* decay of the step size (classical values) */
+#define SPSA_GAMMA 0.101		/* decay of the perturbation */
+
+
+/* Work shared by the threads during an iteration */
+typedef struct {
+	t_gameOptions opt;			/* options of the games (the seed is the one of the first arena of the iteration) */
+	t_params params[2];			/* theta+ and theta- */
+	double budget;
+	int nbGames;				/* 2 games per pair */
+	int nextGame;				/* next game to play (atomic) */
+	int wins;					/* number of games won by theta+ (atomic) */
+	long nbMoves;				/* number of moves played (atomic) */
+} t_work;
+
+
+/* current time, in seconds */
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+
+/* thread: play the games until there is no more */
+static void* worker(void* arg) {
+	t_work* work = arg;
+	int g;
+	while ((g = __atomic_fetch_add(&work->nextGame, 1, __ATOMIC_RELAXED)) < work->nbGames) {
+		/* the two games of a pair share the same arena, and theta+ starts in one of them */
+		t_gameOptions opt = work->opt;
+		opt.seed += g / 2;
+		int plus = g % 2;
+		t_game* game = generateArena(&opt);
+		t_bot* bots[2];
+		bots[plus] = newBot(game, &work->params[0]);
+		bots[1 - plus] = newBot(game, &work->params[1]);
+		int winner = playBotGame(game, bots, work->budget, NULL);
+		if (winner == plus)
+			__atomic_fetch_add(&work->wins, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&work->nbMoves, game->turn, __ATOMIC_RELAXED);
+		freeBot(bots[0]);
+		freeBot(bots[1]);
+		freeGame(game);
+	}
+	return NULL;
+}
+
+
+/* read the checkpoint (parameters and number of iterations done)
+ * Returns the number of iterations already done (0 if there is no checkpoint) */
+static int readCheckpoint(const char* fileName, t_params* params) {
+	if (readParams(fileName, params) < 0)
+		return 0;
+	FILE* f = fopen(fileName, "r");
+	char line[256];
+	int k = 0;
+	while (f && fgets(line, sizeof(line), f))
+		sscanf(line, "iteration=%d", &k);
+	if (f)
+		fclose(f);
+	return k;
+}
+
+
+/* write the checkpoint (in a temporary file first, so that it is never half-written) */
+static void writeCheckpoint(const char* fileName, const t_params* params, int k) {
+	char tmp[1024];
+	snprintf(tmp, sizeof(tmp), "%s.tmp", fileName);
+	FILE* f;
+	if (writeParams(tmp, params) < 0 || !(f = fopen(tmp, "a"))) {
+		dispDebug(__FUNCTION__, 0, "Cannot write the checkpoint %s", tmp);
+		return;
+	}
+	fprintf(f, "iteration=%d\n", k);
+	fclose(f);
+	if (rename(tmp, fileName) < 0)
+		dispDebug(__FUNCTION__, 0, "Cannot rename the checkpoint %s", tmp);
+}
+
+
+int main(int argc, char** argv) {
+	const char* gameType = "difficulty=2 seed=1";
+	const char* checkpoint = NULL;
+	int nbThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	int nbIter = 100, nbPairs = 0;
+	double budget = 0, a = 1.0, c = 1.0;
+	int opt;
+	while ((opt = getopt(argc, argv, "g:t:n:p:b:c:a:C:")) != -1) {
+		switch (opt) {
+			case 'g': gameType = optarg; break;
+			case 't': nbThreads = atoi(optarg); break;
+			case 'n': nbIter = atoi(optarg); break;
+			case 'p': nbPairs = atoi(optarg); break;
+			case 'b': budget = atof(optarg); break;
+			case 'c': checkpoint = optarg; break;
+			case 'a': a = atof(optarg); break;
+			case 'C': c = atof(optarg); break;
+			default:
+				fprintf(stderr, "Usage: %s [-g gameType] [-t threads] [-n iterations] [-p pairs] [-b budget] [-c checkpoint] [-a a] [-C c]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+	if (nbThreads < 1)
+		nbThreads = 1;
+	if (nbPairs < 1)
+		nbPairs = 2 * nbThreads;
+
+	t_work work;
+	if (parseGameType(gameType, &work.opt) < 0)
+		dispError(__FUNCTION__, "Invalid game options \"%s\"", gameType);
+	if (work.opt.seed < 0)
+		work.opt.seed = time(NULL) & 0xFFFFFF;
+	long firstSeed = work.opt.seed;
+	work.budget = budget;
+	work.nbGames = 2 * nbPairs;
+
+	t_params theta;
+	defaultParams(&theta);
+	int k0 = checkpoint ? readCheckpoint(checkpoint, &theta) : 0;
+	if (k0 > 0)
+		printf("Resume from %s at iteration %d\n", checkpoint, k0);
+
+	unsigned long long state = firstSeed ^ 0x5350534154554E45ULL;	/* random generator of the perturbations */
+	for (int i = 0; i < k0; i++)
+		for (int j = 0; j < NB_PARAMS; j++)
+			nextRandom(&state);
+
+	pthread_t* threads = malloc(nbThreads * sizeof(pthread_t));
+	if (!threads)
+		dispError(__FUNCTION__, "Cannot allocate the threads");
+	double A = 0.1 * nbIter;
+	double start = now();
+	long totalGames = 0;
+
+	for (int k = k0; k < nbIter; k++) {
+		double ak = a / pow(k + 1 + A, SPSA_ALPHA);
+		double ck = c / pow(k + 1, SPSA_GAMMA);
+
+		/* random perturbation (+/-1 for each tuned parameter) */
+		int delta[NB_PARAMS];
+		for (int j = 0; j < NB_PARAMS; j++) {
+			delta[j] = (nextRandom(&state) & 1) ? 1 : -1;
+			double d = paramInfo[j].step > 0 ? ck * delta[j] * paramInfo[j].step : 0;
+			work.params[0].v[j] = fmin(fmax(theta.v[j] + d, paramInfo[j].min), paramInfo[j].max);
+			work.params[1].v[j] = fmin(fmax(theta.v[j] - d, paramInfo[j].min), paramInfo[j].max);
+		}
+
+		/* play the games (each iteration has its own arenas) */
+		work.opt.seed = firstSeed + (long) k * nbPairs;
+		work.nextGame = 0;
+		work.wins = 0;
+		work.nbMoves = 0;
+		double t0 = now();
+		for (int i = 0; i < nbThreads; i++)
+			if (pthread_create(&threads[i], NULL, worker, &work))
+				dispError(__FUNCTION__, "Cannot create a thread");
+		for (int i = 0; i < nbThreads; i++)
+			pthread_join(threads[i], NULL);
+		double t = now() - t0;
+		totalGames += work.nbGames;
+
+		/* SPSA update (the gradient is estimated in steps of the parameters) */
+		double r = (2.0 * work.wins - work.nbGames) / work.nbGames;	/* score of theta+ minus score of theta-, in [-1,1] */
+		double norm = 0;
+		for (int j = 0; j < NB_PARAMS; j++) {
+			if (paramInfo[j].step <= 0)
+				continue;
+			double g = r / (2 * ck * delta[j]);
+			double old = theta.v[j];
+			theta.v[j] = fmin(fmax(theta.v[j] + ak * g * paramInfo[j].step, paramInfo[j].min), paramInfo[j].max);
+			double u = (theta.v[j] - old) / paramInfo[j].step;
+			norm += u * u;
+		}
+
+		printf("iteration %d: theta+ won %d/%d, %.1f games/s, %.0f moves/s, update %.4f steps\n",
+			k + 1, work.wins, work.nbGames, work.nbGames / t, work.nbMoves / t, sqrt(norm));
+		for (int j = 0; j < NB_PARAMS; j++)
+			if (paramInfo[j].step > 0)
+				printf("\t%s=%.4f\n", paramInfo[j].name, theta.v[j]);
+		fflush(stdout);
+		if (checkpoint)
+			writeCheckpoint(checkpoint, &theta, k + 1);
+	}
+
+	double t = now() - start;
+	printf("%ld games in %.1fs (%.1f games/s)\n", totalGames, t, totalGames / t);
+	free(threads);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,658 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: tablebase.c
+	Tablebase of a small arena (retrograde analysis, layer by layer)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "clientAPI.h"
+#include "tablebase.h"
+
+
+/* Work of a thread on a range of positions of a layer */
+typedef struct {
+	const t_game* arena;		/* the arena (the snakes are ignored) */
+	int cellBits, t;
+	const uint64_t* keys;		/* positions of the layer t */
+	long first, last;
+	int kw, kwNext;				/* number of words of the keys of the layers t and t+1 */
+	/* forward pass: the positions of the layer t+1 (sorted, without duplicates) */
+	uint64_t* out;
+	long nbOut;
+	/* backward pass: the entries of the layer t, from the ones of the layer t+1 */
+	const uint64_t* nextKeys;
+	long nbNext;
+	const uint64_t* nextValues;
+	uint64_t* values;
+	int width;
+	int error;
+} t_tbJob;
+
+
+/* number of bits needed to write the integers 0 to n-1 */
+static int nbBits(uint64_t n) {
+	int b = 1;
+	while ((1ULL << b) < n)
+		b++;
+	return b;
+}
+
+
+/* write/read n bits (n <= 32) at the position pos of an array of words */
+static inline void putBits(uint64_t* a, uint64_t pos, uint64_t v, int n) {
+	uint64_t w = pos >> 6;
+	int o = pos & 63;
+	a[w] |= v << o;
+	if (o + n > 64)
+		a[w + 1] |= v >> (64 - o);
+}
+
+static inline uint64_t getBits(const uint64_t* a, uint64_t pos, int n) {
+	uint64_t w = pos >> 6;
+	int o = pos & 63;
+	uint64_t v = a[w] >> o;
+	if (o + n > 64)
+		v |= a[w + 1] << (64 - o);
+	return v & ((1ULL << n) - 1);
+}
+
+
+/* number of words of a key at the turn t (the lengths of the snakes only depend on the turn) */
+static int keyWords(int cellBits, int t) {
+	int bits = 2 * cellBits + 2 * (snakeLength((t + 1) / 2) + snakeLength(t / 2) - 2);
+	return (bits + 63) / 64;
+}
+
+
+/* key of a position: for each snake, its head then the directions from each cell to the next one */
+static void encodeKey(const t_game* game, int cellBits, uint64_t* key, int kw) {
+	memset(key, 0, kw * sizeof(uint64_t));
+	uint64_t pos = 0;
+	for (int p = 0; p < 2; p++) {
+		int c = snakeHead(game, p);
+		putBits(key, pos, c, cellBits);
+		pos += cellBits;
+		for (int k = 1; k < game->snake[p].length; k++) {
+			int n = snakeCell(game, p, k), d = 0;
+			while (d < 3 && game->next[4 * c + d] != n)
+				d++;
+			putBits(key, pos, d, 2);
+			pos += 2;
+			c = n;
+		}
+	}
+}
+
+
+/* set the position of a key at the turn t (the arena of the game is kept) */
+static void decodeKey(t_game* game, const uint64_t* key, int cellBits, int t) {
+	memset(game->occupied, 0, game->nbCells);
+	uint64_t pos = 0;
+	for (int p = 0; p < 2; p++) {
+		t_snake* s = &game->snake[p];
+		s->nbMoves = p ? t / 2 : (t + 1) / 2;
+		s->length = snakeLength(s->nbMoves);
+		s->head = s->length - 1;
+		int c = getBits(key, pos, cellBits);
+		pos += cellBits;
+		s->body[s->head] = c;
+		game->occupied[c] = p + 1;
+		for (int k = 1; k < s->length; k++) {
+			c = game->next[4 * c + getBits(key, pos, 2)];
+			pos += 2;
+			s->body[s->head - k] = c;
+			game->occupied[c] = p + 1;
+		}
+	}
+	game->turn = t;
+}
+
+
+/* compare two keys */
+static inline int cmpKey(const uint64_t* a, const uint64_t* b, int kw) {
+	for (int i = kw - 1; i >= 0; i--)
+		if (a[i] != b[i])
+			return a[i] < b[i] ? -1 : 1;
+	return 0;
+}
+
+
+/* index of a key in a sorted array, -1 if it is not there */
+static long findKey(const uint64_t* keys, long n, int kw, const uint64_t* key) {
+	long lo = 0, hi = n;
+	while (lo < hi) {
+		long m = lo + (hi - lo) / 2;
+		if (cmpKey(keys + m * kw, key, kw) < 0)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	return lo < n && cmpKey(keys + lo * kw, key, kw) == 0 ? lo : -1;
+}
+
+
+/* sort an array of keys (merge sort), and remove the duplicates
+ * Returns the number of keys left */
+static long sortKeys(uint64_t* keys, long n, int kw) {
+	uint64_t* tmp = malloc((n ? n : 1) * kw * sizeof(uint64_t));
+	if (!tmp)
+		dispError(__FUNCTION__, "Cannot allocate the keys");
+	uint64_t *src = keys, *dst = tmp;
+	for (long width = 1; width < n; width *= 2) {
+		for (long a = 0; a < n; a += 2 * width) {
+			long m = a + width < n ? a + width : n, b = a + 2 * width < n ? a + 2 * width : n;
+			long i = a, j = m, k = a;
+			while (i < m || j < b) {
+				if (j >= b || (i < m && cmpKey(src + i * kw, src + j * kw, kw) <= 0))
+					memcpy(dst + k++ * kw, src + i++ * kw, kw * sizeof(uint64_t));
+				else
+					memcpy(dst + k++ * kw, src + j++ * kw, kw * sizeof(uint64_t));
+			}
+		}
+		uint64_t* swap = src;
+		src = dst;
+		dst = swap;
+	}
+	if (src != keys)
+		memcpy(keys, src, n * kw * sizeof(uint64_t));
+	free(tmp);
+
+	long nb = 0;
+	for (long i = 0; i < n; i++)
+		if (nb == 0 || cmpKey(keys + (nb - 1) * kw, keys + i * kw, kw) != 0)
+			memmove(keys + nb++ * kw, keys + i * kw, kw * sizeof(uint64_t));
+	return nb;
+}
+
+
+/* thread of the forward pass: the successors of a range of positions */
+static void* forward(void* arg) {
+	t_tbJob* job = arg;
+	t_game* game = newGame(job->arena->sizeX, job->arena->sizeY, 0, NULL);
+	copyGame(game, job->arena);
+	long size = 4 * (job->last - job->first) + 1;
+	job->out = malloc(size * job->kwNext * sizeof(uint64_t));
+	if (!job->out)
+		dispError(__FUNCTION__, "Cannot allocate the positions");
+	job->nbOut = 0;
+	t_undo undo;
+	for (long i = job->first; i < job->last; i++) {
+		decodeKey(game, job->keys + i * job->kw, job->cellBits, job->t);
+		for (t_move m = NORTH; m <= WEST; m++)
+			if (playGameMove(game, m, &undo) == NORMAL_MOVE) {
+				encodeKey(game, job->cellBits, job->out + job->nbOut++ * job->kwNext, job->kwNext);
+				undoGameMove(game, &undo);
+			}
+	}
+	job->nbOut = sortKeys(job->out, job->nbOut, job->kwNext);
+	freeGame(game);
+	return NULL;
+}
+
+
+/* thread of the backward pass: the entries of a range of positions (the range begins on a word) */
+static void* backward(void* arg) {
+	t_tbJob* job = arg;
+	t_game* game = newGame(job->arena->sizeX, job->arena->sizeY, 0, NULL);
+	copyGame(game, job->arena);
+	uint64_t* key = malloc(job->kwNext * sizeof(uint64_t));
+	if (!key)
+		dispError(__FUNCTION__, "Cannot allocate the key");
+	t_undo undo;
+	for (long i = job->first; i < job->last && !job->error; i++) {
+		decodeKey(game, job->keys + i * job->kw, job->cellBits, job->t);
+		/* the player wins if a move leads to a loss of the opponent (the fastest one),
+		 * otherwise he loses (as late as possible) */
+		int nb = 0, win = 0, minWin = 0, maxLoss = 0;
+		for (t_move m = NORTH; m <= WEST; m++)
+			if (playGameMove(game, m, &undo) == NORMAL_MOVE) {
+				encodeKey(game, job->cellBits, key, job->kwNext);
+				undoGameMove(game, &undo);
+				long j = findKey(job->nextKeys, job->nbNext, job->kwNext, key);
+				if (j < 0) {
+					job->error = 1;
+					break;
+				}
+				uint64_t e = getBits(job->nextValues, j * job->width, job->width);
+				int d = e >> 2;
+				if ((e & 3) == TB_LOSS) {
+					if (!win || d < minWin)
+						minWin = d;
+					win = 1;
+				}
+				else if (d > maxLoss)
+					maxLoss = d;
+				nb++;
+			}
+		uint64_t e = nb == 0 ? TB_LOSS : win ? TB_WIN | (uint64_t) (minWin + 1) << 2 : TB_LOSS | (uint64_t) (maxLoss + 1) << 2;
+		putBits(job->values, i * job->width, e, job->width);
+	}
+	free(key);
+	freeGame(game);
+	return NULL;
+}
+
+
+/* run a pass on a layer of n positions, shared by the threads (ranges multiple of 64 positions) */
+static void runPass(t_tbJob* jobs, int nbThreads, long n, void* (*pass)(void*)) {
+	pthread_t threads[nbThreads];
+	long chunk = ((n + nbThreads - 1) / nbThreads + 63) / 64 * 64;
+	for (int k = 0; k < nbThreads; k++) {
+		jobs[k].first = k * chunk < n ? k * chunk : n;
+		jobs[k].last = (k + 1) * chunk < n ? (k + 1) * chunk : n;
+		jobs[k].error = 0;
+		if (pthread_create(&threads[k], NULL, pass, &jobs[k]))
+			dispError(__FUNCTION__, "Cannot create a thread");
+	}
+	for (int k = 0; k < nbThreads; k++)
+		pthread_join(threads[k], NULL);
+}
+
+
+/* merge the sorted successors found by the threads, without the duplicates
+ * (only counted if next is NULL); returns the number of positions */
+static long mergeJobs(const t_tbJob* jobs, int nbThreads, int kw, uint64_t* next) {
+	long nb = 0, pos[nbThreads];
+	const uint64_t* last = NULL;
+	memset(pos, 0, sizeof(pos));
+	while (1) {
+		int best = -1;
+		for (int k = 0; k < nbThreads; k++)
+			if (pos[k] < jobs[k].nbOut && (best < 0
+				|| cmpKey(jobs[k].out + pos[k] * kw, jobs[best].out + pos[best] * kw, kw) < 0))
+				best = k;
+		if (best < 0)
+			break;
+		const uint64_t* key = jobs[best].out + pos[best]++ * kw;
+		if (!last || cmpKey(last, key, kw) != 0) {
+			if (next)
+				memcpy(next + nb * kw, key, kw * sizeof(uint64_t));
+			nb++;
+		}
+		last = key;
+	}
+	return nb;
+}
+
+
+/* write/read exactly size bytes at the offset off of a file */
+static int writeAt(int fd, const void* data, size_t size, uint64_t off) {
+	while (size > 0) {
+		ssize_t r = pwrite(fd, data, size, off);
+		if (r <= 0)
+			return -1;
+		data = (const char*) data + r;
+		size -= r;
+		off += r;
+	}
+	return 0;
+}
+
+static int readAt(int fd, void* data, size_t size, uint64_t off) {
+	while (size > 0) {
+		ssize_t r = pread(fd, data, size, off);
+		if (r <= 0)
+			return -1;
+		data = (char*) data + r;
+		size -= r;
+		off += r;
+	}
+	return 0;
+}
+
+
+/* walls of an arena: 2 bits by cell (wall on the east, wall on the south) */
+static void arenaBits(const t_game* game, uint8_t* bits) {
+	memset(bits, 0, (2 * game->nbCells + 7) / 8);
+	for (int y = 0; y < game->sizeY; y++)
+		for (int x = 0; x < game->sizeX; x++) {
+			int c = CELL(game, x, y);
+			if (x + 1 < game->sizeX && game->next[4 * c + EAST] < 0)
+				bits[(2 * c) >> 3] |= 1 << ((2 * c) & 7);
+			if (y + 1 < game->sizeY && game->next[4 * c + SOUTH] < 0)
+				bits[(2 * c + 1) >> 3] |= 1 << ((2 * c + 1) & 7);
+		}
+}
+
+
+/* -----------------------------------------------------------------------------
+ * Build the tablebase of the arena of a game (at its starting position)
+ *
+ * Parameters:
+ * - game: the game (created by `newGame` with the size and walls given by the server)
+ * - fileName: file of the tablebase
+ * - nbThreads: number of threads (0 for the number of cores)
+ * - maxPositions: maximal number of positions in a layer (the arena is too large above)
+ *
+ * Returns 0 if the tablebase is built, -1 otherwise
+ */
+int tbBuild(const t_game* game, const char* fileName, int nbThreads, long maxPositions) {
+	if (game->turn != 0) {
+		dispDebug(__FUNCTION__, 0, "The game must be at its starting position");
+		return -1;
+	}
+	if (nbThreads < 1)
+		nbThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nbThreads < 1)
+		nbThreads = 1;
+	int fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		dispDebug(__FUNCTION__, 0, "Cannot create %s", fileName);
+		return -1;
+	}
+	int cellBits = nbBits(game->nbCells);
+	t_tbJob* jobs = calloc(nbThreads, sizeof(t_tbJob));
+	if (!jobs)
+		dispError(__FUNCTION__, "Cannot allocate the jobs");
+	for (int k = 0; k < nbThreads; k++) {
+		jobs[k].arena = game;
+		jobs[k].cellBits = cellBits;
+	}
+	int ok = 1;
+
+	/* walls */
+	uint64_t off = sizeof(t_tbHeader);
+	size_t wallSize = (2 * game->nbCells + 7) / 8;
+	uint8_t* bits = malloc(wallSize);
+	if (!bits)
+		dispError(__FUNCTION__, "Cannot allocate the walls");
+	arenaBits(game, bits);
+	ok = writeAt(fd, bits, wallSize, off) == 0;
+	free(bits);
+	uint64_t wallsOffset = off;
+	off = (off + wallSize + 7) / 8 * 8;
+
+	/* forward pass: the layers of positions, written as they are found */
+	int nbLayers = 0, sizeLayers = 64;
+	t_tbLayer* layers = malloc(sizeLayers * sizeof(t_tbLayer));
+	int kw = keyWords(cellBits, 0);
+	long n = 1;
+	uint64_t* keys = malloc(kw * sizeof(uint64_t));
+	if (!layers || !keys)
+		dispError(__FUNCTION__, "Cannot allocate the layers");
+	encodeKey(game, cellBits, keys, kw);
+	while (ok && n > 0) {
+		if (nbLayers == sizeLayers) {
+			sizeLayers *= 2;
+			layers = realloc(layers, sizeLayers * sizeof(t_tbLayer));
+			if (!layers)
+				dispError(__FUNCTION__, "Cannot allocate the layers");
+		}
+		int t = nbLayers++;
+		t_tbLayer* l = &layers[t];
+		memset(l, 0, sizeof(t_tbLayer));
+		l->nb = n;
+		l->keyWords = kw;
+		l->keys = off;
+		ok = writeAt(fd, keys, n * kw * sizeof(uint64_t), off) == 0;
+		off += n * kw * sizeof(uint64_t);
+		dispDebug(__FUNCTION__, 1, "Layer %d: %ld positions", t, n);
+
+		/* successors (each thread sorts its own, then they are merged) */
+		int kwNext = keyWords(cellBits, t + 1);
+		for (int k = 0; k < nbThreads; k++) {
+			jobs[k].t = t;
+			jobs[k].keys = keys;
+			jobs[k].kw = kw;
+			jobs[k].kwNext = kwNext;
+		}
+		runPass(jobs, nbThreads, n, forward);
+		/* the size of the layer is checked before it is allocated (the threads may have found
+		 * the same positions, so they are counted first when there are too many) */
+		long total = 0;
+		for (int k = 0; k < nbThreads; k++)
+			total += jobs[k].nbOut;
+		if (total > maxPositions)
+			total = mergeJobs(jobs, nbThreads, kwNext, NULL);
+		uint64_t* next = NULL;
+		if (total > maxPositions) {
+			dispDebug(__FUNCTION__, 0, "Too many positions (%ld at turn %d), the arena is too large", total, t + 1);
+			ok = 0;
+		}
+		else {
+			next = malloc((total ? total : 1) * kwNext * sizeof(uint64_t));
+			if (!next)
+				dispError(__FUNCTION__, "Cannot allocate the positions");
+			n = mergeJobs(jobs, nbThreads, kwNext, next);
+		}
+		for (int k = 0; k < nbThreads; k++)
+			free(jobs[k].out);
+		free(keys);
+		keys = next;
+		kw = kwNext;
+	}
+	free(keys);
+
+	/* offsets of the entries */
+	int distBits = nbBits(nbLayers), width = 2 + distBits;
+	for (int t = 0; t < nbLayers; t++) {
+		off = (off + 7) / 8 * 8;
+		layers[t].values = off;
+		off += (layers[t].nb * width + 63) / 64 * sizeof(uint64_t);
+	}
+	uint64_t layersOffset = off;
+	off += nbLayers * sizeof(t_tbLayer);
+
+	/* backward pass: the entries of the layer t from the ones of the layer t+1 */
+	uint64_t *nextKeys = NULL, *nextValues = NULL;
+	for (int t = nbLayers - 1; ok && t >= 0; t--) {
+		t_tbLayer* l = &layers[t];
+		uint64_t words = (l->nb * width + 63) / 64;
+		keys = malloc(l->nb * l->keyWords * sizeof(uint64_t));
+		uint64_t* values = calloc(words, sizeof(uint64_t));
+		if (!keys || !values)
+			dispError(__FUNCTION__, "Cannot allocate the layer %d", t);
+		ok = readAt(fd, keys, l->nb * l->keyWords * sizeof(uint64_t), l->keys) == 0;
+		for (int k = 0; k < nbThreads; k++) {
+			jobs[k].t = t;
+			jobs[k].keys = keys;
+			jobs[k].kw = l->keyWords;
+			jobs[k].kwNext = keyWords(cellBits, t + 1);
+			jobs[k].nextKeys = nextKeys;
+			jobs[k].nbNext = t + 1 < nbLayers ? layers[t + 1].nb : 0;
+			jobs[k].nextValues = nextValues;
+			jobs[k].values = values;
+			jobs[k].width = width;
+		}
+		if (ok)
+			runPass(jobs, nbThreads, l->nb, backward);
+		for (int k = 0; k < nbThreads; k++)
+			if (jobs[k].error) {
+				dispDebug(__FUNCTION__, 0, "A successor of the layer %d is missing", t);
+				ok = 0;
+			}
+		ok = ok && writeAt(fd, values, words * sizeof(uint64_t), l->values) == 0;
+		free(nextKeys);
+		free(nextValues);
+		nextKeys = keys;
+		nextValues = values;
+	}
+	free(nextKeys);
+	free(nextValues);
+
+	/* layers and header */
+	t_tbHeader head;
+	memset(&head, 0, sizeof(head));
+	memcpy(head.magic, TB_MAGIC, 8);
+	head.version = TB_VERSION;
+	head.sizeX = game->sizeX;
+	head.sizeY = game->sizeY;
+	head.nbLayers = nbLayers;
+	head.distBits = distBits;
+	head.walls = wallsOffset;
+	head.layers = layersOffset;
+	head.size = off;
+	ok = ok && writeAt(fd, layers, nbLayers * sizeof(t_tbLayer), layersOffset) == 0
+		&& writeAt(fd, &head, sizeof(head), 0) == 0;
+	ok = close(fd) == 0 && ok;
+	if (!ok)
+		unlink(fileName);
+	free(layers);
+	free(jobs);
+	return ok ? 0 : -1;
+}
+
+
+/* ------------------------------------------------------------------
+ * Open a tablebase (mapped in memory)
+ *
+ * Returns the tablebase, NULL if the file cannot be read or is invalid
+ */
+t_tablebase* tbOpen(const char* fileName) {
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (size_t) st.st_size < sizeof(t_tbHeader)) {
+		close(fd);
+		return NULL;
+	}
+	const uint8_t* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	/* check the header and the layers */
+	const t_tbHeader* head = (const t_tbHeader*) map;
+	uint64_t size = st.st_size;
+	int cellBits = nbBits((uint64_t) head->sizeX * head->sizeY);
+	int valid = memcmp(head->magic, TB_MAGIC, 8) == 0 && head->version == TB_VERSION && head->size == size
+		&& head->walls <= size && (2 * (uint64_t) head->sizeX * head->sizeY + 7) / 8 <= size - head->walls && head->layers % 8 == 0
+		&& head->layers <= size && head->nbLayers * (uint64_t) sizeof(t_tbLayer) <= size - head->layers && head->distBits < 30;
+	const t_tbLayer* layers = (const t_tbLayer*) (map + head->layers);
+	int width = 2 + head->distBits;
+	for (uint32_t t = 0; valid && t < head->nbLayers; t++) {
+		const t_tbLayer* l = &layers[t];
+		valid = l->keyWords == (uint32_t) keyWords(cellBits, t) && l->keys % 8 == 0 && l->values % 8 == 0
+			&& l->nb < size && l->keys <= size && l->nb * l->keyWords * sizeof(uint64_t) <= size - l->keys
+			&& l->values <= size && (l->nb * width + 63) / 64 * sizeof(uint64_t) <= size - l->values;
+	}
+	if (!valid) {
+		munmap((void*) map, st.st_size);
+		return NULL;
+	}
+
+	t_tablebase* tb = malloc(sizeof(t_tablebase));
+	if (!tb)
+		dispError(__FUNCTION__, "Cannot allocate the tablebase");
+	tb->map = map;
+	tb->size = st.st_size;
+	tb->head = head;
+	tb->layers = layers;
+	tb->cellBits = cellBits;
+	return tb;
+}
+
+
+/* ------------------
+ * Close a tablebase
+ */
+void tbFree(t_tablebase* tb) {
+	if (!tb)
+		return;
+	munmap((void*) tb->map, tb->size);
+	free(tb);
+}
+
+
+/* ----------------------------------------------------------
+ * Indicates if the tablebase is the one of the arena of the game
+ */
+int tbMatches(const t_tablebase* tb, const t_game* game) {
+	if (tb->head->sizeX != game->sizeX || tb->head->sizeY != game->sizeY)
+		return 0;
+	size_t n = (2 * game->nbCells + 7) / 8;
+	uint8_t* bits = malloc(n);
+	if (!bits)
+		dispError(__FUNCTION__, "Cannot allocate the walls");
+	arenaBits(game, bits);
+	int same = memcmp(bits, tb->map + tb->head->walls, n) == 0;
+	free(bits);
+	return same;
+}
+
+
+/* -----------------------------------------------------------------------
+ * Value of the position of a game (of the arena of the tablebase)
+ *
+ * Parameters:
+ * - tb: the tablebase
+ * - game: the game
+ * - dist: (can be NULL) filled with the number of moves until the end of the game
+ *
+ * Returns TB_WIN or TB_LOSS for the player that has to play, TB_UNKNOWN if the position is not in the tablebase
+ */
+int tbProbe(const t_tablebase* tb, const t_game* game, int* dist) {
+	if (game->turn < 0 || (uint32_t) game->turn >= tb->head->nbLayers)
+		return TB_UNKNOWN;
+	const t_tbLayer* l = &tb->layers[game->turn];
+	uint64_t key[l->keyWords];
+	encodeKey(game, tb->cellBits, key, l->keyWords);
+	long i = findKey((const uint64_t*) (tb->map + l->keys), l->nb, l->keyWords, key);
+	if (i < 0)
+		return TB_UNKNOWN;
+	int width = 2 + tb->head->distBits;
+	uint64_t e = getBits((const uint64_t*) (tb->map + l->values), i * width, width);
+	if (dist)
+		*dist = e >> 2;
+	return e & 3;
+}
+
+
+/* -----------------------------------------------------------------------
+ * Best move of a position: the fastest win, or the longest loss
+ *
+ * Parameters:
+ * - tb: the tablebase
+ * - game: the game (the moves are played and undone)
+ * - move: filled with the best move
+ * - dist: (can be NULL) filled with the number of moves until the end of the game (-1 if the position is not in the tablebase)
+ *
+ * Returns the value of the position (as `tbProbe`), the move is given only for TB_WIN and TB_LOSS
+ * (when the player has a legal move)
+ */
+int tbBestMove(const t_tablebase* tb, t_game* game, t_move* move, int* dist) {
+	int d = -1;
+	int v = tbProbe(tb, game, &d);
+	if (dist)
+		*dist = d;
+	if (v != TB_WIN && v != TB_LOSS)
+		return v;
+	/* the move that leads to the position whose distance is the one of the position minus one */
+	t_undo undo;
+	for (t_move m = NORTH; m <= WEST; m++)
+		if (playGameMove(game, m, &undo) == NORMAL_MOVE) {
+			int cd = -1;
+			int cv = tbProbe(tb, game, &cd);
+			undoGameMove(game, &undo);
+			if (cd == d - 1 && cv == (v == TB_WIN ? TB_LOSS : TB_WIN)) {
+				*move = m;
+				break;
+			}
+		}
+	return v;
+}
@@ -0,0 +1,149 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: tablebase.h
+	Tablebase of a small arena: exact value (win or loss for the player that has to play)
+	and distance to the end (in moves, with a perfect play) of all the positions reachable
+	from the starting positions
+
+	Each move increases the turn, so the positions are organized in layers (one by turn):
+	a forward pass enumerates the layer t+1 from the layer t, then a backward pass computes
+	the values from the last layer to the first one (the threads share each layer)
+	The file contains, for each layer, the sorted keys of its positions (the heads and the
+	directions of the bodies, bit-packed) and their values (2 bits, then the distance),
+	bit-packed; it is read in place (mmap)
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_TABLEBASE__
+#define __SNAKE_TABLEBASE__
+#include <stdint.h>
+#include "snakeGame.h"
+
+
+#define TB_MAGIC "SNAKETB1"
+#define TB_VERSION 1
+
+
+/* value of a position (for the player that has to play) */
+enum {
+	TB_UNKNOWN = 0,		/* not in the tablebase */
+	TB_WIN = 1,
+	TB_LOSS = 2,
+	TB_DRAW = 3			/* not produced by the rules (a game always ends), kept for the format */
+};
+
+
+/* header of the file */
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint16_t sizeX, sizeY;
+	uint32_t nbLayers;
+	uint32_t distBits;		/* an entry is value | distance << 2, on 2+distBits bits */
+	uint64_t walls;			/* offset of the walls (2 bits by cell: wall on the east, wall on the south) */
+	uint64_t layers;		/* offset of the layers (t_tbLayer[nbLayers]) */
+	uint64_t size;			/* size of the file */
+} t_tbHeader;
+
+
+/* a layer (positions of a turn) */
+typedef struct {
+	uint64_t nb;			/* number of positions */
+	uint32_t keyWords;		/* number of 64-bit words of a key */
+	uint32_t reserved;
+	uint64_t keys;			/* offset of the keys (sorted) */
+	uint64_t values;		/* offset of the entries */
+} t_tbLayer;
+
+
+/* A tablebase (mapped in memory) */
+typedef struct {
+	const uint8_t* map;
+	size_t size;
+	const t_tbHeader* head;
+	const t_tbLayer* layers;
+	int cellBits;			/* number of bits of a cell */
+} t_tablebase;
+
+
+
+/* -----------------------------------------------------------------------------
+ * Build the tablebase of the arena of a game (at its starting position)
+ *
+ * Parameters:
+ * - game: the game (created by `newGame` with the size and walls given by the server)
+ * - fileName: file of the tablebase
+ * - nbThreads: number of threads (0 for the number of cores)
+ * - maxPositions: maximal number of positions in a layer (the arena is too large above)
+ *
+ * Returns 0 if the tablebase is built, -1 otherwise
+ */
+int tbBuild(const t_game* game, const char* fileName, int nbThreads, long maxPositions);
+
+
+/* ------------------------------------------------------------------
+ * Open a tablebase (mapped in memory)
+ *
+ * Returns the tablebase, NULL if the file cannot be read or is invalid
+ */
+t_tablebase* tbOpen(const char* fileName);
+
+
+/* ------------------
+ * Close a tablebase
+ */
+void tbFree(t_tablebase* tb);
+
+
+/* ----------------------------------------------------------
+ * Indicates if the tablebase is the one of the arena of the game
+ */
+int tbMatches(const t_tablebase* tb, const t_game* game);
+
+
+/* -----------------------------------------------------------------------
+ * Value of the position of a game (of the arena of the tablebase)
+ *
+ * Parameters:
+ * - tb: the tablebase
+ * - game: the game
+ * - dist: (can be NULL) filled with the number of moves until the end of the game
+ *
+ * Returns TB_WIN or TB_LOSS for the player that has to play, TB_UNKNOWN if the position is not in the tablebase
+ */
+int tbProbe(const t_tablebase* tb, const t_game* game, int* dist);
+
+
+/* -----------------------------------------------------------------------
+ * Best move of a position: the fastest win, or the longest loss
+ *
+ * Parameters:
+ * - tb: the tablebase
+ * - game: the game (the moves are played and undone)
+ * - move: filled with the best move
+ * - dist: (can be NULL) filled with the number of moves until the end of the game (-1 if the position is not in the tablebase)
+ *
+ * Returns the value of the position (as `tbProbe`), the move is given only for TB_WIN and TB_LOSS
+ * (when the player has a legal move)
+ */
+int tbBestMove(const t_tablebase* tb, t_game* game, t_move* move, int* dist);
+
+
+#endif
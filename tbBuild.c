@@ -0,0 +1,86 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: tbBuild.c
+	Build the tablebase (tablebase.h) of a small arena, generated locally (arenaGen.h)
+	with the same options as the server, and give the value of its starting position
+
+	Compile with: gcc -O2 tbBuild.c tablebase.c arenaGen.c snakeGame.c clientAPI.c -pthread
+
+	Usage: tbBuild [-g gameType] [-t threads] [-m positions] [-o file]
+	  -g: options of the arena ("difficulty=0 sizeX=6 sizeY=3" by default)
+	  -t: number of threads (number of cores by default)
+	  -m: maximal number of positions in a layer (100000000 by default)
+	  -o: file of the tablebase ("arena.tb" by default)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include "clientAPI.h"
+#include "arenaGen.h"
+#include "tablebase.h"
+
+
+int main(int argc, char** argv) {
+	const char* gameType = "difficulty=0 sizeX=6 sizeY=3";
+	const char* fileName = "arena.tb";
+	int nbThreads = 0;
+	long maxPositions = 100000000;
+	int opt;
+	while ((opt = getopt(argc, argv, "g:t:m:o:")) != -1) {
+		switch (opt) {
+			case 'g': gameType = optarg; break;
+			case 't': nbThreads = atoi(optarg); break;
+			case 'm': maxPositions = atol(optarg); break;
+			case 'o': fileName = optarg; break;
+			default:
+				fprintf(stderr, "Usage: %s [-g gameType] [-t threads] [-m positions] [-o file]\n", argv[0]);
+				return EXIT_FAILURE;
+		}
+	}
+	t_gameOptions gameOpt;
+	if (parseGameType(gameType, &gameOpt) < 0)
+		dispError(__FUNCTION__, "Invalid game options \"%s\"", gameType);
+	t_game* game = generateArena(&gameOpt);
+
+	struct timespec t0, t1;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	if (tbBuild(game, fileName, nbThreads, maxPositions) < 0)
+		dispError(__FUNCTION__, "Cannot build the tablebase of the arena %dx%d", game->sizeX, game->sizeY);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	/* summary, and value of the starting position */
+	t_tablebase* tb = tbOpen(fileName);
+	if (!tb)
+		dispError(__FUNCTION__, "Cannot read the tablebase %s", fileName);
+	unsigned long long nb = 0;
+	for (uint32_t t = 0; t < tb->head->nbLayers; t++)
+		nb += tb->layers[t].nb;
+	int dist;
+	t_move move = NORTH;
+	int v = tbBestMove(tb, game, &move, &dist);
+	printf("%s: arena %dx%d, %u turns, %llu positions, %zu bytes (%.2fs)\n", fileName, game->sizeX, game->sizeY,
+		tb->head->nbLayers, nb, tb->size, (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9);
+	printf("starting position: the player 0 %s in %d moves (best move: %d)\n", v == TB_WIN ? "wins" : "loses", dist, move);
+	tbFree(tb);
+	freeGame(game);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: timedOcc.c
+	Time-expanded occupancy of the arena: each cell stores the turn from which it
+	can be entered (the body of a snake is released by its tail, except when it grows)
+
+Copyright 2024 T. Hilaire
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "clientAPI.h"
+#include "timedOcc.h"
+
+
+/* ---------------------------------------------------
+ * Create the occupancy of a game (at its current position)
+ */
+t_timedOcc* newTimedOcc(const t_game* game) {
+	int n = game->nbCells;
+	t_timedOcc* occ = malloc(sizeof(t_timedOcc));
+	if (!occ)
+		dispError(__FUNCTION__, "Cannot allocate the occupancy");
+	occ->nbCells = n;
+	occ->next = malloc(4 * n * sizeof(int));
+	occ->release = calloc(n + 1, sizeof(int));
+	occ->dist = malloc((n + 1) * sizeof(int));
+	occ->stamp = calloc(n + 1, sizeof(int));
+	occ->queue = malloc(n * sizeof(int));
+	if (!occ->next || !occ->release || !occ->dist || !occ->stamp || !occ->queue)
+		dispError(__FUNCTION__, "Cannot allocate the occupancy");
+	occ->mark = 0;
+
+	/* the walls lead to the sentinel cell */
+	for (int i = 0; i < 4 * n; i++)
+		occ->next[i] = game->next[i] < 0 ? n : game->next[i];
+	occ->release[n] = INT_MAX;
+
+	/* the k-th cell of a snake (from its head) was entered by its move nbMoves-1-k */
+	occ->turn = game->turn;
+	for (int p = 0; p < 2; p++) {
+		const t_snake* s = &game->snake[p];
+		occ->head[p] = snakeHead(game, p);
+		occ->nbMoves[p] = s->nbMoves;
+		for (int k = 0; k < s->length; k++)
+			occ->release[snakeCell(game, p, k)] = releaseTurn(p, s->nbMoves - 1 - k);
+	}
+	return occ;
+}
+
+
+/* --------------------
+ * Free an occupancy
+ */
+void freeTimedOcc(t_timedOcc* occ) {
+	if (!occ)
+		return;
+	free(occ->next);
+	free(occ->release);
+	free(occ->dist);
+	free(occ->stamp);
+	free(occ->queue);
+	free(occ);
+}
+
+
+/* -------------------------------------------------------------------------------
+ * Time-aware BFS from the head of the snake p: a cell can be crossed if the snake
+ * reaches it after its release (the opponent is supposed to stay where it is)
+ * occ->dist[c] is then the number of moves to reach c, valid if occ->stamp[c]==occ->mark
+ *
+ * Parameters:
+ * - occ: the occupancy
+ * - p: the player
+ * - maxMoves: maximal number of moves explored (0 for no limit)
+ *
+ * Returns the number of cells reached
+ */
+int timedReach(t_timedOcc* occ, int p, int maxMoves) {
+	const int* next = occ->next;
+	const int* release = occ->release;
+	int* dist = occ->dist;
+	int* stamp = occ->stamp;
+	int* queue = occ->queue;
+	int mark = ++occ->mark;
+	if (maxMoves <= 0)
+		maxMoves = INT_MAX;
+
+	/* the k-th move of p (k=1,2,...) is played at the turn t0 + 2(k-1) */
+	int t0 = occ->turn + ((occ->turn & 1) != p);
+	int h = occ->head[p];
+	int first = 0, last = 0;
+	stamp[h] = mark;
+	stamp[occ->nbCells] = mark;		/* the walls are never entered */
+	dist[h] = 0;
+	queue[last++] = h;
+	while (first < last) {
+		int c = queue[first++];
+		int k = dist[c] + 1;
+		if (k > maxMoves)
+			break;
+		int t = t0 + 2 * (k - 1);
+		for (int d = 0; d < 4; d++) {
+			int n = next[4 * c + d];
+			if (stamp[n] != mark && t >= release[n]) {
+				stamp[n] = mark;
+				dist[n] = k;
+				queue[last++] = n;
+			}
+		}
+	}
+	return last - 1;
+}
+
+
+/* ------------------------------------------------------------------------------
+ * Function to give to `addMoveListener`, so that the occupancy follows the game
+ * (data is the occupancy)
+ */
+void timedListener(t_move move, int ours, t_return_code ret, void* data) {
+	(void) ours;
+	if (ret == NORMAL_MOVE)
+		timedPlay((t_timedOcc*) data, move, NULL);
+}
@@ -0,0 +1,144 @@
+/* --------------------------------------------- *
+ |                                               |
+ |                                               |
+ |   ░░░░░░░ ░░░    ░░  ░░░░░  ░░   ░░ ░░░░░░░   |
+ |   ▒▒      ▒▒▒▒   ▒▒ ▒▒   ▒▒ ▒▒  ▒▒  ▒▒        |
+ |   ▒▒▒▒▒▒▒ ▒▒ ▒▒  ▒▒ ▒▒▒▒▒▒▒ ▒▒▒▒▒   ▒▒▒▒▒     |
+ |        ▓▓ ▓▓  ▓▓ ▓▓ ▓▓   ▓▓ ▓▓  ▓▓  ▓▓        |
+ |   ███████ ██   ████ ██   ██ ██   ██ ███████   |
+ |                                               |
+ |                                               |
+ |   Based on CodingGameServer                   |
+ |                                               |
+ * --------------------------------------------- *
+
+Authors: T. Hilaire
+Licence: GPL
+
+File: timedOcc.h
+	Time-expanded occupancy of the arena: each cell stores the turn from which it
+	can be entered (the body of a snake is released by its tail, except when it grows)
+
+	The growth schedule is fixed (every 10 moves of a snake, move 0 included), so the
+	cell entered by the move e of the snake p is released at a turn known in advance:
+	the release turns never change, and a move only sets the one of the new head
+
+Copyright 2024 T. Hilaire
+*/
+
+
+#ifndef __SNAKE_TIMED_OCC__
+#define __SNAKE_TIMED_OCC__
+#include "snakeGame.h"
+
+
+/* The occupancy */
+typedef struct {
+	int nbCells;
+	int* next;			/* next[4*c+d]: neighbour of c, or nbCells (a sentinel cell never released) for a wall */
+	int* release;		/* release[c]: first turn at which a move can enter c (0 for a free cell) */
+	int head[2];
+	int nbMoves[2];		/* number of moves played by each snake */
+	int turn;			/* number of moves played (both players) */
+	int* dist;			/* distances computed by `timedReach` */
+	int* stamp;			/* stamp[c]==mark if dist[c] is valid */
+	int mark;
+	int* queue;
+} t_timedOcc;
+
+
+/* Information needed to undo a move */
+typedef struct {
+	int cell;			/* cell entered */
+	int oldRelease;
+	int oldHead;
+} t_timedUndo;
+
+
+/* ------------------------------------------------------------------------
+ * Turn at which the cell entered by the move e of the snake p is released
+ * (e=-1 for the starting cell)
+ */
+static inline int releaseTurn(int p, int e) {
+	/* it is the (e+2)-th cell of the snake, freed by its (e+2)-th move that does not grow;
+	 * among the moves 0..i, i-i/10 do not grow */
+	int k = e + 2;
+	int r = k + (k - 1) / 9;
+	return 2 * r + p;
+}
+
+
+/* ---------------------------------------------------
+ * Create the occupancy of a game (at its current position)
+ */
+t_timedOcc* newTimedOcc(const t_game* game);
+
+
+/* --------------------
+ * Free an occupancy
+ */
+void freeTimedOcc(t_timedOcc* occ);
+
+
+/* ---------------------------------------------------------------------
+ * Play a move for the player that has to play (the move must be legal)
+ * undo can be NULL
+ */
+static inline void timedPlay(t_timedOcc* occ, t_move move, t_timedUndo* undo) {
+	int p = occ->turn & 1;
+	int c = occ->next[4 * occ->head[p] + move];
+	if (undo) {
+		undo->cell = c;
+		undo->oldRelease = occ->release[c];
+		undo->oldHead = occ->head[p];
+	}
+	occ->release[c] = releaseTurn(p, occ->nbMoves[p]);
+	occ->head[p] = c;
+	occ->nbMoves[p]++;
+	occ->turn++;
+}
+
+
+/* ---------------------------
+ * Undo the last move played
+ */
+static inline void timedUndo(t_timedOcc* occ, const t_timedUndo* undo) {
+	occ->turn--;
+	int p = occ->turn & 1;
+	occ->nbMoves[p]--;
+	occ->head[p] = undo->oldHead;
+	occ->release[undo->cell] = undo->oldRelease;
+}
+
+
+/* ---------------------------------------------------------------------
+ * Indicates if the move is legal for the player that has to play
+ */
+static inline int timedLegal(const t_timedOcc* occ, t_move move) {
+	return occ->turn >= occ->release[occ->next[4 * occ->head[occ->turn & 1] + move]];
+}
+
+
+/* -------------------------------------------------------------------------------
+ * Time-aware BFS from the head of the snake p: a cell can be crossed if the snake
+ * reaches it after its release (the opponent is supposed to stay where it is)
+ * occ->dist[c] is then the number of moves to reach c, valid if occ->stamp[c]==occ->mark
+ *
+ * Parameters:
+ * - occ: the occupancy
+ * - p: the player
+ * - maxMoves: maximal number of moves explored (0 for no limit)
+ *
+ * Returns the number of cells reached
+ */
+int timedReach(t_timedOcc* occ, int p, int maxMoves);
+
+
+/* ------------------------------------------------------------------------------
+ * Function to give to `addMoveListener`, so that the occupancy follows the game
+ * (data is the occupancy)
+ */
+void timedListener(t_move move, int ours, t_return_code ret, void* data);
+
+
+#endif